@@ -24,12 +24,28 @@ extern "C" {
 int thingset_bluetooth_send_report(const char *path);
 
 /**
- * Send ThingSet message (response or report) to Bluetooth Central.
+ * Send ThingSet report to Bluetooth client using a pre-resolved report handle.
+ *
+ * @param handle Pointer to initialized handle of subset, group or item that should be reported
+ *
+ * @returns 0 for success or negative errno in case of error
+ */
+int thingset_bluetooth_send_report_handle(const struct thingset_report_handle *handle);
+
+/**
+ * Send ThingSet message (response or report) to all Bluetooth Centrals which subscribed to
+ * notifications.
+ *
+ * The message is split into notifications, of which up to
+ * CONFIG_THINGSET_BLUETOOTH_NOTIFY_IN_FLIGHT are queued in the Bluetooth stack at the same time.
+ * If the limit is reached, the function blocks until previous notifications were sent.
+ *
+ * Responses to requests processed by the SDK are only sent to the requesting Central.
  *
  * @param buf Buffer with ThingSet message (w/o SLIP characters)
  * @param len Length of message
  *
- * @returns 0 for success or negative errno in case of error
+ * @returns 0 for success, -EIO if no Central subscribed or other negative errno in case of error
  */
 int thingset_bluetooth_send(const uint8_t *buf, size_t len);
 
@@ -37,7 +53,8 @@ int thingset_bluetooth_send(const uint8_t *buf, size_t len);
  * Set custom callback for received data.
  *
  * If this callback is set, ThingSet messages are not processed automatically anymore, but
- * forwarded through the callback.
+ * forwarded through the callback. Messages sent with thingset_bluetooth_send() from the callback
+ * are received by all connected Centrals.
  */
 void thingset_bluetooth_set_rx_callback(thingset_sdk_rx_callback_t rx_cb);
 
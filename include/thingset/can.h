@@ -10,6 +10,8 @@
 #include <zephyr/canbus/isotp.h>
 #include <zephyr/device.h>
 
+#include <thingset/sdk.h>
+
 #include "canbus/isotp_fast.h"
 
 #ifdef __cplusplus
@@ -244,20 +246,54 @@ struct thingset_can_request_response
     void *cb_arg;
 };
 
+/**
+ * Type of a message sent via ISO-TP, defining what has to be done after it was sent
+ */
+enum thingset_can_tx_type
+{
+    /** Response to a received request, the response buffer is released */
+    THINGSET_CAN_TX_RESPONSE,
+    /** Request of the application, the request/response callback is notified */
+    THINGSET_CAN_TX_REQUEST,
+    /** Other message of the application without response */
+    THINGSET_CAN_TX_MESSAGE,
+    THINGSET_CAN_TX_NUM_TYPES,
+};
+
+struct thingset_can;
+
+/**
+ * Context passed to the ISO-TP sent callback to identify the message that was sent
+ */
+struct thingset_can_tx_ctx
+{
+    struct thingset_can *ts_can;
+    enum thingset_can_tx_type type;
+};
+
 /**
  * ThingSet CAN context storing all information required for one instance.
  */
 struct thingset_can
 {
     const struct device *dev;
-    struct k_work_delayable live_reporting_work;
+#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
+    /** Sink receiving the live reports encoded by the SDK */
+    struct thingset_report_sink live_report_sink;
+#endif
 #ifdef CONFIG_THINGSET_CAN_CONTROL_REPORTING
-    struct k_work_delayable control_reporting_work;
+    struct thingset_report_job control_reporting_job;
 #endif
     struct k_work_delayable addr_claim_work;
     thingset_can_addr_claim_rx_callback_t addr_claim_callback;
     struct isotp_fast_ctx ctx;
     struct k_sem report_tx_sem;
+    /** Locked while a response to a received request is being sent */
+    struct k_sem rsp_lock;
+    /** TX buffer of the response currently being sent */
+    struct shared_buffer *rsp_buf;
+    /** Sent callback contexts for the different message types */
+    struct thingset_can_tx_ctx tx_ctx[THINGSET_CAN_TX_NUM_TYPES];
     struct k_event events;
     struct thingset_can_request_response request_response;
     uint8_t rx_buffer[CONFIG_THINGSET_CAN_RX_BUF_SIZE];
@@ -267,11 +303,9 @@ struct thingset_can
 #ifdef CONFIG_THINGSET_CAN_ITEM_RX
     thingset_can_item_rx_callback_t item_rx_cb;
 #endif
-    int64_t next_live_report_time;
 #ifdef CONFIG_THINGSET_CAN_CONTROL_REPORTING
     bool control_enable;
     uint32_t control_period;
-    int64_t next_control_report_time;
 #endif
     struct k_timer timeout_timer;
     uint8_t node_addr;
@@ -294,6 +328,19 @@ struct thingset_can
 int thingset_can_send_report_inst(struct thingset_can *ts_can, const char *path,
                                   enum thingset_data_format format);
 
+/**
+ * Send ThingSet report to the CAN bus using a pre-resolved report handle.
+ *
+ * @param ts_can Pointer to the thingset_can context.
+ * @param handle Pointer to initialized handle of subset/group/record to be published
+ * @param format Protocol data format to be used (text, binary with IDs or binary with names)
+ *
+ * @returns 0 for success or negative errno in case of error
+ */
+int thingset_can_send_report_handle_inst(struct thingset_can *ts_can,
+                                         const struct thingset_report_handle *handle,
+                                         enum thingset_data_format format);
+
 /**
  * Send ThingSet message to other node
  *
@@ -380,6 +427,17 @@ int thingset_can_init_inst(struct thingset_can *ts_can, const struct device *can
  */
 int thingset_can_send_report(const char *path, enum thingset_data_format format);
 
+/**
+ * Send ThingSet report to the CAN bus using a pre-resolved report handle.
+ *
+ * @param handle Pointer to initialized handle of subset/group/record to be published
+ * @param format Protocol data format to be used (text, binary with IDs or binary with names)
+ *
+ * @returns 0 for success or negative errno in case of error
+ */
+int thingset_can_send_report_handle(const struct thingset_report_handle *handle,
+                                    enum thingset_data_format format);
+
 /**
  * Send ThingSet message to other node
  *
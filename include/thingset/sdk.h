@@ -30,6 +30,8 @@ extern "C" {
  * | 0x40 - 0x1FF  | Application   | Available for custom application-specific objects |
  * | 0x200 - 0x2FF | ThingSet SDK  | Sub-objects of above groups and related overlays  |
  * | 0x300 - 0x37F | ThingSet SDK  | Sub-objects of _Reporting overlay                 |
+ * | 0x380 - 0x3FF | -             | Reserved (not used)                               |
+ * | 0x400 - 0x43F | ThingSet SDK  | Interface counters of _Stats overlay              |
  */
 
 /* IDs from ThingSet node library */
@@ -66,7 +68,66 @@ extern "C" {
 #define TS_ID_NET_WEBSOCKET_PORT       0x285
 #define TS_ID_NET_WEBSOCKET_USE_TLS    0x286
 #define TS_ID_NET_WEBSOCKET_AUTH_TOKEN 0x287
+#define TS_ID_NET_SERIAL_SET_BAUDRATE  0x288
+#define TS_ID_NET_SERIAL_BAUDRATE      0x289
+#define TS_ID_NET_BLE_MTU              0x28A
+#define TS_ID_NET_BLE_PHY              0x28B
 #define TS_ID_NET_CAN_NODE_ADDR        0x28C
+#define TS_ID_NET_BLE_DATA_LEN         0x28D
+
+/* _Stats overlay with traffic counters of the interfaces */
+#define TS_ID_STATS                      0x2B
+#define TS_ID_STATS_RESET                0x2B0
+#define TS_ID_STATS_SERIAL               0x2B1
+#define TS_ID_STATS_BLUETOOTH            0x2B2
+#define TS_ID_STATS_CAN                  0x2B3
+#define TS_ID_STATS_WEBSOCKET            0x2B4
+
+#define TS_ID_STATS_SERIAL_REQUESTS      0x400
+#define TS_ID_STATS_SERIAL_RESPONSES     0x401
+#define TS_ID_STATS_SERIAL_REPORTS       0x402
+#define TS_ID_STATS_SERIAL_BYTES_IN      0x403
+#define TS_ID_STATS_SERIAL_BYTES_OUT     0x404
+#define TS_ID_STATS_SERIAL_RX_DROPPED    0x405
+#define TS_ID_STATS_SERIAL_CRC_ERRORS    0x406
+#define TS_ID_STATS_SERIAL_TIMEOUTS      0x407
+#define TS_ID_STATS_SERIAL_QUEUE_DELAY   0x408
+#define TS_ID_STATS_SERIAL_SERVICE_TIME  0x409
+
+#define TS_ID_STATS_BLUETOOTH_REQUESTS      0x410
+#define TS_ID_STATS_BLUETOOTH_RESPONSES     0x411
+#define TS_ID_STATS_BLUETOOTH_REPORTS       0x412
+#define TS_ID_STATS_BLUETOOTH_BYTES_IN      0x413
+#define TS_ID_STATS_BLUETOOTH_BYTES_OUT     0x414
+#define TS_ID_STATS_BLUETOOTH_RX_DROPPED    0x415
+#define TS_ID_STATS_BLUETOOTH_CRC_ERRORS    0x416
+#define TS_ID_STATS_BLUETOOTH_TIMEOUTS      0x417
+#define TS_ID_STATS_BLUETOOTH_QUEUE_DELAY   0x418
+#define TS_ID_STATS_BLUETOOTH_SERVICE_TIME  0x419
+#define TS_ID_STATS_BLUETOOTH_NOTIFY_QUEUED 0x41A
+#define TS_ID_STATS_BLUETOOTH_NOTIFY_FAILED 0x41B
+
+#define TS_ID_STATS_CAN_REQUESTS         0x420
+#define TS_ID_STATS_CAN_RESPONSES        0x421
+#define TS_ID_STATS_CAN_REPORTS          0x422
+#define TS_ID_STATS_CAN_BYTES_IN         0x423
+#define TS_ID_STATS_CAN_BYTES_OUT        0x424
+#define TS_ID_STATS_CAN_RX_DROPPED       0x425
+#define TS_ID_STATS_CAN_CRC_ERRORS       0x426
+#define TS_ID_STATS_CAN_TIMEOUTS         0x427
+#define TS_ID_STATS_CAN_QUEUE_DELAY      0x428
+#define TS_ID_STATS_CAN_SERVICE_TIME     0x429
+
+#define TS_ID_STATS_WEBSOCKET_REQUESTS     0x430
+#define TS_ID_STATS_WEBSOCKET_RESPONSES    0x431
+#define TS_ID_STATS_WEBSOCKET_REPORTS      0x432
+#define TS_ID_STATS_WEBSOCKET_BYTES_IN     0x433
+#define TS_ID_STATS_WEBSOCKET_BYTES_OUT    0x434
+#define TS_ID_STATS_WEBSOCKET_RX_DROPPED   0x435
+#define TS_ID_STATS_WEBSOCKET_CRC_ERRORS   0x436
+#define TS_ID_STATS_WEBSOCKET_TIMEOUTS     0x437
+#define TS_ID_STATS_WEBSOCKET_QUEUE_DELAY  0x438
+#define TS_ID_STATS_WEBSOCKET_SERVICE_TIME 0x439
 
 /* Device Firmware Upgrade group items */
 #define TS_ID_DFU       0x2D
@@ -89,12 +150,24 @@ extern "C" {
 /* _Reporting overlay top-level object */
 #define TS_ID_REPORTING 0x2F
 
+/* _Reporting overlay items not related to a particular subset */
+#define TS_ID_REP_CACHE_HITS    0x300
+#define TS_ID_REP_CACHE_MISSES  0x301
+#define TS_ID_REP_SCHED_MISSED  0x302
+#define TS_ID_REP_SCHED_JITTER  0x303
+#define TS_ID_REP_BUF_SKIPPED   0x304
+#define TS_ID_REP_BUF_COALESCED 0x305
+#define TS_ID_REP_BUF_WAITED    0x306
+#define TS_ID_REP_BUF_TIMEOUTS  0x307
+
 /* Subsets defined by SDK */
-#define TS_NAME_SUBSET_LIVE   "mLive"
-#define TS_ID_SUBSET_LIVE     0x31
-#define TS_ID_REP_LIVE        0x310
-#define TS_ID_REP_LIVE_ENABLE 0x311
-#define TS_ID_REP_LIVE_PERIOD 0x313 // in ms (0x312 was used to store period in s)
+#define TS_NAME_SUBSET_LIVE              "mLive"
+#define TS_ID_SUBSET_LIVE                0x31
+#define TS_ID_REP_LIVE                   0x310
+#define TS_ID_REP_LIVE_ENABLE            0x311
+#define TS_ID_REP_LIVE_PERIOD            0x313 // in ms (0x312 was used to store period in s)
+#define TS_ID_REP_LIVE_ON_CHANGE         0x314
+#define TS_ID_REP_LIVE_KEYFRAME_INTERVAL 0x315
 
 #define TS_NAME_SUBSET_SUMMARY   "mSummary"
 #define TS_ID_SUBSET_SUMMARY     0x32
@@ -121,11 +194,60 @@ extern bool pub_events_enable;
 extern bool live_reporting_enable;
 extern uint32_t live_reporting_period;
 
+extern bool live_reporting_on_change;
+extern uint32_t live_reporting_keyframe_interval;
+
 extern bool summary_reporting_enable;
 extern uint32_t summary_reporting_period;
 
 extern struct thingset_context ts;
 
+/**
+ * Priority classes of the ThingSet SDK work queues
+ */
+enum thingset_sdk_work_prio
+{
+    /** Request processing and time-critical reports */
+    THINGSET_SDK_PRIO_HIGH,
+    /** Slow or non-critical tasks like storage access and reconnects */
+    THINGSET_SDK_PRIO_BACKGROUND,
+};
+
+struct thingset_report_job;
+
+/**
+ * Function called by the report scheduler to send a periodic report
+ *
+ * @param job Pointer to the job, which can be used to obtain the context via CONTAINER_OF
+ */
+typedef void (*thingset_report_job_fn_t)(struct thingset_report_job *job);
+
+/**
+ * Periodic report handled by the central report scheduler of the SDK
+ *
+ * The scheduler staggers the phases of all jobs, so that they don't fire in the same tick.
+ * Periods missed due to high load are skipped instead of being sent in a burst.
+ */
+struct thingset_report_job
+{
+    /** Function sending the report */
+    thingset_report_job_fn_t fn;
+    /** Pointer to the reporting period, which may be changed at runtime */
+    const uint32_t *period;
+    /** Unit of the period in milliseconds (e.g. 1000 for a period in seconds) */
+    uint32_t period_unit_ms;
+    /** Priority class of the work queue running the job */
+    enum thingset_sdk_work_prio prio;
+    /** Number of periods skipped because the job was executed too late */
+    uint32_t missed;
+    /** Maximum delay between scheduled and actual execution of the job in milliseconds */
+    uint32_t max_jitter;
+    /** Scheduled time of the next execution (internal) */
+    int64_t deadline;
+    /** Work item used by the scheduler (internal) */
+    struct k_work_delayable work;
+};
+
 struct shared_buffer
 {
     struct k_sem lock;
@@ -139,19 +261,236 @@ struct shared_buffer
  */
 typedef void (*thingset_sdk_rx_callback_t)(const uint8_t *buf, size_t len);
 
+/**
+ * Data object to be reported, resolved once to avoid path lookups for each report
+ */
+struct thingset_report_handle
+{
+    /** Subset, group or item to be reported */
+    const struct thingset_data_object *obj;
+    /** Path used in the report header or NULL if it has to be generated */
+    const char *path;
+};
+
+struct thingset_report_sink;
+
+/**
+ * Callback typedef for sending an already encoded report via a specific interface
+ *
+ * @param sink Pointer to the sink the report is sent to
+ * @param buf Pointer to the encoded report
+ * @param len Length of the encoded report
+ *
+ * @returns 0 if the report was sent or no receiver is connected, negative errno if the report
+ *          was lost (the next on-change report is a full report then)
+ */
+typedef int (*thingset_report_sink_send_t)(struct thingset_report_sink *sink, const uint8_t *buf,
+                                           size_t len);
+
+/**
+ * Interface receiving the live reports published by the SDK
+ */
+struct thingset_report_sink
+{
+    sys_snode_t node;
+    /** Data format expected by the interface */
+    enum thingset_data_format format;
+    /** Function called with the encoded report */
+    thingset_report_sink_send_t send;
+};
+
 /**
  * Get TX buffer that can be shared between different ThingSet interfaces
  *
+ * This function is kept for backwards compatibility. It always returns the same large buffer of
+ * the TX buffer pool, which has to be locked via its semaphore before use. New code should use
+ * thingset_sdk_tx_buf_acquire() instead.
+ *
  * @returns Pointer to shared_buffer instance
  */
 struct shared_buffer *thingset_sdk_shared_buffer(void);
 
+/**
+ * Acquire a TX buffer from the SDK buffer pool
+ *
+ * The smallest currently unused buffer with at least the requested size is returned, so different
+ * interfaces only have to wait for each other if all suitable buffers are in use.
+ *
+ * @param min_size Minimum size of the buffer in bytes
+ * @param timeout Maximum time to wait until a suitable buffer becomes available
+ *
+ * @returns Pointer to the acquired buffer or NULL if no buffer was available within the timeout
+ */
+struct shared_buffer *thingset_sdk_tx_buf_acquire(size_t min_size, k_timeout_t timeout);
+
+/**
+ * Behavior of thingset_sdk_tx_buf_acquire_policy() if no suitable TX buffer is available
+ */
+enum thingset_sdk_tx_buf_policy
+{
+    /** Return immediately, the message is dropped */
+    THINGSET_SDK_TX_BUF_SKIP,
+    /** Return immediately, the caller merges the content into its next message */
+    THINGSET_SDK_TX_BUF_COALESCE,
+    /** Wait for a buffer until the timeout expires */
+    THINGSET_SDK_TX_BUF_WAIT,
+};
+
+/**
+ * Acquire a TX buffer from the SDK buffer pool with explicit backpressure policy
+ *
+ * Same as thingset_sdk_tx_buf_acquire(), but the decision taken if the pool is exhausted is
+ * counted in the _Reporting overlay, so that load shedding can be monitored.
+ *
+ * @param min_size Minimum size of the buffer in bytes
+ * @param policy Action to take if no suitable buffer is available immediately
+ * @param timeout Maximum time to wait for a buffer (only used with THINGSET_SDK_TX_BUF_WAIT)
+ *
+ * @returns Pointer to the acquired buffer or NULL if the message has to be skipped or coalesced
+ */
+struct shared_buffer *thingset_sdk_tx_buf_acquire_policy(size_t min_size,
+                                                         enum thingset_sdk_tx_buf_policy policy,
+                                                         k_timeout_t timeout);
+
+/**
+ * Release a TX buffer previously obtained via thingset_sdk_tx_buf_acquire()
+ *
+ * @param buf Pointer to the buffer that should be returned to the pool
+ */
+void thingset_sdk_tx_buf_release(struct shared_buffer *buf);
+
+/**
+ * Process a ThingSet request received by one of the interfaces
+ *
+ * Same as thingset_process_message() for the global ThingSet context, but additionally
+ * invalidates the report cache if the request may have changed any data.
+ *
+ * @param msg Pointer to the received request
+ * @param msg_len Length of the request
+ * @param rsp Pointer to the buffer where the response should be stored
+ * @param rsp_size Size of the response buffer
+ *
+ * @returns Length of the response or negative value in case of error
+ */
+int thingset_sdk_process_message(const uint8_t *msg, size_t msg_len, uint8_t *rsp,
+                                 size_t rsp_size);
+
+/**
+ * Resolve the path of a subset, group or item to be reported
+ *
+ * @param handle Pointer to the handle to be initialized
+ * @param path Path of the object, which has to stay valid as long as the handle is used
+ *
+ * @returns 0 for success or -ENOENT if the object was not found
+ */
+int thingset_sdk_report_handle_init(struct thingset_report_handle *handle, const char *path);
+
+/**
+ * Resolve the ID of a subset, group or item to be reported
+ *
+ * @param handle Pointer to the handle to be initialized
+ * @param id ID of the object
+ *
+ * @returns 0 for success or -ENOENT if the object was not found
+ */
+int thingset_sdk_report_handle_init_by_id(struct thingset_report_handle *handle, uint16_t id);
+
+/**
+ * Encode a report of the object referenced by the handle
+ *
+ * @param handle Pointer to an initialized report handle
+ * @param buf Pointer to the buffer where the report should be stored
+ * @param size Size of the buffer
+ * @param format Protocol data format to be used
+ *
+ * @returns Length of the report or negative value in case of error
+ */
+int thingset_sdk_report_by_handle(const struct thingset_report_handle *handle, uint8_t *buf,
+                                  size_t size, enum thingset_data_format format);
+
+/**
+ * Encode a report of a subset or take it from the report cache
+ *
+ * Without CONFIG_THINGSET_REPORT_CACHE or for handles not referring to a subset, the report is
+ * always encoded again.
+ *
+ * @param handle Pointer to an initialized report handle of the subset
+ * @param buf Pointer to the buffer where the report should be stored
+ * @param size Size of the buffer
+ * @param format Protocol data format to be used
+ *
+ * @returns Length of the report or negative value in case of error
+ */
+int thingset_sdk_report_subset(const struct thingset_report_handle *handle, uint8_t *buf,
+                               size_t size, enum thingset_data_format format);
+
+/**
+ * Mark cached reports of the given subsets as outdated
+ *
+ * Has to be called by the application after updating data objects which are part of a cached
+ * subset. Must not be called from ISR context.
+ *
+ * @param subsets Subset flags of the updated data objects
+ */
+void thingset_sdk_report_mark_dirty(uint16_t subsets);
+
+/**
+ * Set the deadband for on-change reporting of an item of the live metrics subset
+ *
+ * With on-change reporting enabled, the item is only included in the next report if its value
+ * moved by more than the absolute or the relative deadband since it was reported last time, i.e.
+ * the smaller threshold applies. A deadband of 0 is ignored, and items without any deadband are
+ * reported on any change. Non-numeric items are always reported on any change.
+ *
+ * @param id ID of the data object
+ * @param abs_deadband Absolute deadband in the unit of the item
+ * @param rel_deadband Relative deadband (e.g. 0.05 for 5%) based on the last reported value
+ *
+ * @returns 0 for success or -ENOENT if the item is not tracked for on-change reporting
+ */
+int thingset_sdk_report_set_deadband(uint16_t id, float abs_deadband, float rel_deadband);
+
+/**
+ * Register an interface to receive live reports
+ *
+ * The live report is encoded only once per data format and period and then passed on to all
+ * registered sinks.
+ *
+ * @param sink Pointer to the sink, which has to stay valid as long as reporting is running
+ */
+void thingset_sdk_register_report_sink(struct thingset_report_sink *sink);
+
+/**
+ * Start a periodic report job
+ *
+ * The fn, period, period_unit_ms and prio fields of the job have to be set before.
+ *
+ * @param job Pointer to the job, which has to stay valid as long as reporting is running
+ */
+void thingset_sdk_report_job_start(struct thingset_report_job *job);
+
 /**
  * Add delayable work to the common ThingSet SDK work queue. This should be used to offload
  * processing of incoming requests and sending out reports.
+ *
+ * Same as thingset_sdk_reschedule_work_prio() with THINGSET_SDK_PRIO_HIGH.
  */
 int thingset_sdk_reschedule_work(struct k_work_delayable *dwork, k_timeout_t delay);
 
+/**
+ * Add delayable work to the ThingSet SDK work queue of the given priority class.
+ *
+ * Without CONFIG_THINGSET_SDK_BACKGROUND_WORKQ all work is handled by the same queue.
+ *
+ * @param dwork Pointer to the delayable work item
+ * @param delay Time to wait before the work is submitted to the queue
+ * @param prio Priority class of the work
+ *
+ * @returns Same as k_work_reschedule_for_queue()
+ */
+int thingset_sdk_reschedule_work_prio(struct k_work_delayable *dwork, k_timeout_t delay,
+                                      enum thingset_sdk_work_prio prio);
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,6 +14,20 @@
 extern "C" {
 #endif
 
+/**
+ * Logical channels multiplexed over the serial link if CONFIG_THINGSET_SERIAL_CHANNELS is
+ * enabled. The channel ID is the first byte of each binary frame.
+ */
+enum thingset_serial_channel
+{
+    /** ThingSet messages of the local node */
+    THINGSET_SERIAL_CHANNEL_LOCAL = 0,
+    /** Messages of remote nodes forwarded by a gateway application */
+    THINGSET_SERIAL_CHANNEL_GATEWAY = 1,
+    /** Log output (device to host only) */
+    THINGSET_SERIAL_CHANNEL_LOG = 2,
+};
+
 /**
  * Send ThingSet report to serial client.
  *
@@ -23,6 +37,35 @@ extern "C" {
  */
 int thingset_serial_send_report(const char *path);
 
+/**
+ * Send ThingSet report to serial client using a pre-resolved report handle.
+ *
+ * @param handle Pointer to initialized handle of subset, group or item that should be reported
+ *
+ * @returns 0 for success or negative errno in case of error
+ */
+int thingset_serial_send_report_handle(const struct thingset_report_handle *handle);
+
+/**
+ * Send a large ThingSet subset report to serial client in chunks.
+ *
+ * The report is encoded progressively into buffers of CONFIG_THINGSET_SERIAL_REPORT_CHUNK_SIZE
+ * bytes, and each chunk is transmitted while the next one is encoded. So reports can exceed the
+ * size of the shared TX buffers. The ThingSet context stays locked until the last chunk was
+ * encoded, and other messages are only sent after the entire report.
+ *
+ * While the context is locked, no chunk waits for TX buffers used by other interfaces. The stream
+ * is aborted with -EBUSY instead, leaving an incomplete line without CRC.
+ *
+ * Other objects than subsets and reports in binary mode are sent in one piece via
+ * thingset_serial_send_report_handle().
+ *
+ * @param handle Pointer to initialized handle of the subset that should be reported
+ *
+ * @returns 0 for success or negative errno in case of error
+ */
+int thingset_serial_send_report_stream(const struct thingset_report_handle *handle);
+
 /**
  * Send ThingSet message (response or report) to serial client.
  *
@@ -33,11 +76,32 @@ int thingset_serial_send_report(const char *path);
  */
 int thingset_serial_send(const uint8_t *buf, size_t len);
 
+/**
+ * Send a message on a logical channel of the serial link.
+ *
+ * Messages on the gateway and log channel are always sent as binary frames with the channel ID
+ * as the first byte. The payload can be text or binary. Log messages are dropped instead of
+ * waiting if no TX buffer is available, so that they never delay ThingSet traffic.
+ *
+ * Only available if CONFIG_THINGSET_SERIAL_CHANNELS is enabled.
+ *
+ * @param channel Logical channel the message is sent on
+ * @param buf Buffer with the message
+ * @param len Length of message
+ *
+ * @returns 0 for success or negative errno in case of error
+ */
+int thingset_serial_send_channel(enum thingset_serial_channel channel, const uint8_t *buf,
+                                 size_t len);
+
 /**
  * Set custom callback for received data.
  *
  * If this callback is set, ThingSet messages are not processed automatically anymore, but
  * forwarded through the callback.
+ *
+ * If CONFIG_THINGSET_SERIAL_CHANNELS is enabled, only messages received on the gateway channel
+ * are forwarded through the callback, while messages for the local node are still processed.
  */
 void thingset_serial_set_rx_callback(thingset_sdk_rx_callback_t rx_cb);
 
@@ -7,12 +7,23 @@
 #ifndef THINGSET_WEBSOCKET_H_
 #define THINGSET_WEBSOCKET_H_
 
+#include <thingset/sdk.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 int thingset_websocket_send_report(const char *path);
 
+/**
+ * Send ThingSet report to WebSocket server using a pre-resolved report handle.
+ *
+ * @param handle Pointer to initialized handle of subset, group or item that should be reported
+ *
+ * @returns 0 for success or negative errno in case of error
+ */
+int thingset_websocket_send_report_handle(const struct thingset_report_handle *handle);
+
 #ifdef __cplusplus
 }
 #endif
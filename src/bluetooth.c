@@ -22,6 +22,7 @@
 #include <string.h>
 
 #include "packetizer.h"
+#include "stats.h"
 
 LOG_MODULE_REGISTER(thingset_bluetooth, CONFIG_THINGSET_SDK_LOG_LEVEL);
 
@@ -51,6 +52,15 @@ static void thingset_bluetooth_conn(struct bt_conn *conn, uint8_t err);
 
 static void thingset_bluetooth_ccc_change(const struct bt_gatt_attr *attr, uint16_t value);
 
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+static void thingset_bluetooth_phy_updated(struct bt_conn *conn, struct bt_conn_le_phy_info *info);
+#endif
+
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+static void thingset_bluetooth_data_len_updated(struct bt_conn *conn,
+                                                struct bt_conn_le_data_len_info *info);
+#endif
+
 static const struct bt_data ad[] = {
     BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
     BT_DATA(BT_DATA_NAME_COMPLETE, DEVICE_NAME, DEVICE_NAME_LEN),
@@ -63,6 +73,12 @@ static const struct bt_data sd[] = {
 BT_CONN_CB_DEFINE(conn_callbacks) = {
     .connected = thingset_bluetooth_conn,
     .disconnected = thingset_bluetooth_disconn,
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+    .le_phy_updated = thingset_bluetooth_phy_updated,
+#endif
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+    .le_data_len_updated = thingset_bluetooth_data_len_updated,
+#endif
 };
 
 /* UART Service Declaration, order of parameters matters! */
@@ -79,31 +95,106 @@ BT_GATT_SERVICE_DEFINE(thingset_svc, BT_GATT_PRIMARY_SERVICE(BT_UUID_THINGSET_SE
 /* position of BT_GATT_CCC in array created by BT_GATT_SERVICE_DEFINE */
 const struct bt_gatt_attr *attr_ccc_req = &thingset_svc.attrs[3];
 
-static struct bt_conn *ble_conn;
-
-volatile bool notify_resp;
-
-static char rx_buf[CONFIG_THINGSET_BLUETOOTH_RX_BUF_SIZE];
+/* state of one connection to a Bluetooth Central */
+struct ble_conn_ctx
+{
+    /** Connection or NULL if the context is unused */
+    struct bt_conn *conn;
+
+    char rx_buf[CONFIG_THINGSET_BLUETOOTH_RX_BUF_SIZE];
+    int rx_buf_pos;
+    /** Escape character received at the end of the previous package */
+    bool rx_escape;
+    bool discard_buffer;
+    /** Time when the last request was received completely */
+    uint32_t rx_timestamp;
+    /** Binary semaphore used as mutex in ISR context */
+    struct k_sem rx_buf_lock;
+
+    struct k_work_delayable processing_work;
+
+    /** Held while a message is sent, so that chunks of different messages don't interleave */
+    struct k_mutex tx_lock;
+
+    /** One credit per notification that may be queued in the Bluetooth stack */
+    struct k_sem notify_credits;
+    /** Number of notifications of this connection waiting for completion */
+    uint32_t notify_queued;
+
+#ifdef CONFIG_THINGSET_BLUETOOTH_CONN_PARAMS_UPDATE
+    struct k_work_delayable params_work;
+    struct bt_gatt_exchange_params mtu_exchange_params;
+#endif
+};
 
-static size_t rx_buf_pos = 0;
-static bool discard_buffer;
+static struct ble_conn_ctx conn_ctxs[CONFIG_BT_MAX_CONN];
 
-/* binary semaphore used as mutex in ISR context */
-static struct k_sem rx_buf_lock;
+/* protects the connection pointers, which are changed from the Bluetooth RX thread */
+static struct k_spinlock conn_lock;
 
 static thingset_sdk_rx_callback_t rx_callback;
 
-static struct k_work_delayable processing_work;
 static struct k_work_delayable adv_work;
-#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-static struct k_work_delayable reporting_work;
+
+/* number of notifications waiting for completion and number of failed notifications */
+static uint32_t notify_queued;
+static uint32_t notify_failed;
+static struct k_spinlock notify_lock;
+
+/* link parameters of the most recently established or updated connection, not per connection */
+static uint16_t link_mtu;
+static uint8_t link_phy;
+static uint16_t link_data_len;
+
+THINGSET_ADD_ITEM_UINT16(TS_ID_NET, TS_ID_NET_BLE_MTU, "rBleMTU", &link_mtu, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT8(TS_ID_NET, TS_ID_NET_BLE_PHY, "rBlePHY", &link_phy, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT16(TS_ID_NET, TS_ID_NET_BLE_DATA_LEN, "rBleDataLen", &link_data_len,
+                         THINGSET_ANY_R, 0);
+
+#ifdef CONFIG_THINGSET_STATS
+THINGSET_ADD_ITEM_UINT32(TS_ID_STATS_BLUETOOTH, TS_ID_STATS_BLUETOOTH_NOTIFY_QUEUED,
+                         "rNotifyQueued", &notify_queued, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(TS_ID_STATS_BLUETOOTH, TS_ID_STATS_BLUETOOTH_NOTIFY_FAILED,
+                         "rNotifyFailed", &notify_failed, THINGSET_ANY_R, 0);
 #endif
 
+static inline struct ble_conn_ctx *conn_ctx_get(struct bt_conn *conn)
+{
+    return &conn_ctxs[bt_conn_index(conn)];
+}
+
+/*
+ * Get a reference to the connection of a context, so that it stays valid even if the Central
+ * disconnects in the meantime. Returns NULL if the context is unused.
+ */
+static struct bt_conn *conn_ctx_ref(struct ble_conn_ctx *ctx)
+{
+    k_spinlock_key_t key = k_spin_lock(&conn_lock);
+    struct bt_conn *conn = ctx->conn != NULL ? bt_conn_ref(ctx->conn) : NULL;
+    k_spin_unlock(&conn_lock, key);
+
+    return conn;
+}
+
+/* notifications are only sent to connections which subscribed via their own CCC */
+static bool conn_ctx_subscribed(struct ble_conn_ctx *ctx)
+{
+    struct bt_conn *conn = conn_ctx_ref(ctx);
+    if (conn == NULL) {
+        return false;
+    }
+
+    bool subscribed = bt_gatt_is_subscribed(conn, attr_ccc_req, BT_GATT_CCC_NOTIFY);
+    bt_conn_unref(conn);
+
+    return subscribed;
+}
+
 static void thingset_bluetooth_ccc_change(const struct bt_gatt_attr *attr, uint16_t value)
 {
+    /* value is the aggregate of all connections, subscriptions are checked per connection */
     ARG_UNUSED(attr);
-    notify_resp = (value == BT_GATT_CCC_NOTIFY);
-    LOG_INF("Notification %s", notify_resp ? "enabled" : "disabled");
+    LOG_INF("Notification %s", (value == BT_GATT_CCC_NOTIFY) ? "enabled" : "disabled");
 }
 
 /*
@@ -112,123 +203,422 @@ static void thingset_bluetooth_ccc_change(const struct bt_gatt_attr *attr, uint1
 static ssize_t thingset_bluetooth_rx(struct bt_conn *conn, const struct bt_gatt_attr *attr,
                                      const void *buf, uint16_t len, uint16_t offset, uint8_t flags)
 {
-    /* store across multiple packages whether we had an escape char */
-    static bool escape = false;
+    struct ble_conn_ctx *ctx = conn_ctx_get(conn);
 
-    if (k_sem_take(&rx_buf_lock, K_NO_WAIT) == 0) {
-        bool finished = reassemble((uint8_t *)buf, len, rx_buf,
-                                   CONFIG_THINGSET_BLUETOOTH_RX_BUF_SIZE, &rx_buf_pos, &escape);
+    stats_add(STATS_BLUETOOTH, STATS_BYTES_IN, len);
+
+    if (k_sem_take(&ctx->rx_buf_lock, K_NO_WAIT) == 0) {
+        bool finished = reassemble((uint8_t *)buf, len, ctx->rx_buf, sizeof(ctx->rx_buf),
+                                   &ctx->rx_buf_pos, &ctx->rx_escape);
         if (finished) {
-            if (discard_buffer) {
-                rx_buf_pos = 0;
-                discard_buffer = false;
-                k_sem_give(&rx_buf_lock);
+            if (ctx->discard_buffer) {
+                stats_inc(STATS_BLUETOOTH, STATS_RX_DROPPED);
+                ctx->rx_buf_pos = 0;
+                ctx->discard_buffer = false;
+                k_sem_give(&ctx->rx_buf_lock);
                 return len;
             }
             else {
-                rx_buf[rx_buf_pos] = '\0';
+                ctx->rx_buf[ctx->rx_buf_pos] = '\0';
+                ctx->rx_timestamp = stats_timestamp();
                 /* start processing the request and keep the rx_buf_lock */
-                thingset_sdk_reschedule_work(&processing_work, K_NO_WAIT);
+                thingset_sdk_reschedule_work(&ctx->processing_work, K_NO_WAIT);
                 return len;
             }
         }
-        k_sem_give(&rx_buf_lock);
+        k_sem_give(&ctx->rx_buf_lock);
     }
     else {
         /* buffer not available: drop incoming data */
         LOG_HEXDUMP_WRN(buf, len, "Discarded buffer");
-        discard_buffer = true;
+        ctx->discard_buffer = true;
     }
 
     return len;
 }
 
+#ifdef CONFIG_THINGSET_BLUETOOTH_CONN_PARAMS_UPDATE
+
+static void mtu_exchange_cb(struct bt_conn *conn, uint8_t err,
+                            struct bt_gatt_exchange_params *params)
+{
+    if (err) {
+        LOG_WRN("MTU exchange failed (err %u)", err);
+    }
+}
+
+/*
+ * Request faster link parameters from the SDK work queue, as the requests may block while
+ * waiting for buffers, which must not happen in the Bluetooth RX thread.
+ */
+static void conn_params_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct ble_conn_ctx *ctx = CONTAINER_OF(dwork, struct ble_conn_ctx, params_work);
+    int err;
+
+    struct bt_conn *conn = conn_ctx_ref(ctx);
+    if (conn == NULL) {
+        return;
+    }
+
+    ctx->mtu_exchange_params.func = mtu_exchange_cb;
+    err = bt_gatt_exchange_mtu(conn, &ctx->mtu_exchange_params);
+    if (err && err != -EALREADY) {
+        LOG_WRN("MTU exchange request failed (err %d)", err);
+    }
+
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+    err = bt_conn_le_phy_update(conn, BT_CONN_LE_PHY_PARAM_2M);
+    if (err) {
+        LOG_WRN("PHY update request failed (err %d)", err);
+    }
+#endif
+
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+    err = bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+    if (err) {
+        LOG_WRN("Data length update request failed (err %d)", err);
+    }
+#endif
+
+    bt_conn_unref(conn);
+}
+
+#endif /* CONFIG_THINGSET_BLUETOOTH_CONN_PARAMS_UPDATE */
+
+static void thingset_bluetooth_mtu_updated(struct bt_conn *conn, uint16_t tx, uint16_t rx)
+{
+    link_mtu = bt_gatt_get_mtu(conn);
+    LOG_INF("ATT MTU updated: %u", link_mtu);
+}
+
+static struct bt_gatt_cb gatt_callbacks = {
+    .att_mtu_updated = thingset_bluetooth_mtu_updated,
+};
+
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+static void thingset_bluetooth_phy_updated(struct bt_conn *conn, struct bt_conn_le_phy_info *info)
+{
+    link_phy = info->tx_phy;
+    LOG_INF("PHY updated: TX %u, RX %u", info->tx_phy, info->rx_phy);
+}
+#endif
+
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+static void thingset_bluetooth_data_len_updated(struct bt_conn *conn,
+                                                struct bt_conn_le_data_len_info *info)
+{
+    link_data_len = info->tx_max_len;
+    LOG_INF("Data length updated: TX %u, RX %u bytes", info->tx_max_len, info->rx_max_len);
+}
+#endif
+
+/* return all notification credits, as pending notifications are not completed anymore */
+static void conn_ctx_reset_notify(struct ble_conn_ctx *ctx)
+{
+    k_spinlock_key_t key = k_spin_lock(&notify_lock);
+    notify_queued -= ctx->notify_queued;
+    ctx->notify_queued = 0;
+    k_spin_unlock(&notify_lock, key);
+
+    k_sem_reset(&ctx->notify_credits);
+    for (int i = 0; i < CONFIG_THINGSET_BLUETOOTH_NOTIFY_IN_FLIGHT; i++) {
+        k_sem_give(&ctx->notify_credits);
+    }
+}
+
 static void thingset_bluetooth_conn(struct bt_conn *conn, uint8_t err)
 {
     char addr[BT_ADDR_LE_STR_LEN];
 
     if (err) {
         LOG_ERR("Connection failed (err %u)", err);
+        thingset_sdk_reschedule_work_prio(&adv_work, K_NO_WAIT, THINGSET_SDK_PRIO_BACKGROUND);
         return;
     }
 
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
     LOG_INF("Connected %s", addr);
 
-    ble_conn = bt_conn_ref(conn);
+    struct ble_conn_ctx *ctx = conn_ctx_get(conn);
+
+    /* discard incomplete data of a previous connection using the same context */
+    if (k_sem_take(&ctx->rx_buf_lock, K_NO_WAIT) == 0) {
+        ctx->rx_buf_pos = 0;
+        k_sem_give(&ctx->rx_buf_lock);
+    }
+    ctx->discard_buffer = false;
+    ctx->rx_escape = false;
+    conn_ctx_reset_notify(ctx);
+
+    k_spinlock_key_t key = k_spin_lock(&conn_lock);
+    ctx->conn = bt_conn_ref(conn);
+    k_spin_unlock(&conn_lock, key);
+
+    /* default parameters until the updates are completed */
+    link_mtu = bt_gatt_get_mtu(conn);
+    link_phy = BT_GAP_LE_PHY_1M;
+    link_data_len = 27;
+
+#ifdef CONFIG_THINGSET_BLUETOOTH_CONN_PARAMS_UPDATE
+    thingset_sdk_reschedule_work(&ctx->params_work, K_NO_WAIT);
+#endif
+
+    /* advertising stops with each connection, so continue for further Centrals */
+    thingset_sdk_reschedule_work_prio(&adv_work, K_NO_WAIT, THINGSET_SDK_PRIO_BACKGROUND);
 }
 
 static void thingset_bluetooth_disconn(struct bt_conn *conn, uint8_t reason)
 {
     char addr[BT_ADDR_LE_STR_LEN];
+    struct ble_conn_ctx *ctx = conn_ctx_get(conn);
 
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
     LOG_INF("Disconnected %s (reason %u)", addr, reason);
 
-    if (ble_conn) {
-        bt_conn_unref(ble_conn);
-        ble_conn = NULL;
+    /* senders still using the connection hold their own reference */
+    k_spinlock_key_t key = k_spin_lock(&conn_lock);
+    struct bt_conn *old_conn = ctx->conn;
+    ctx->conn = NULL;
+    k_spin_unlock(&conn_lock, key);
+
+    if (old_conn) {
+        bt_conn_unref(old_conn);
     }
 
-    thingset_sdk_reschedule_work(&adv_work, K_NO_WAIT);
+    conn_ctx_reset_notify(ctx);
+
+    thingset_sdk_reschedule_work_prio(&adv_work, K_NO_WAIT, THINGSET_SDK_PRIO_BACKGROUND);
 }
 
-int thingset_bluetooth_send(const uint8_t *buf, size_t len)
+static void notify_complete_cb(struct bt_conn *conn, void *user_data)
 {
-    if (ble_conn && notify_resp) {
-        /* Max. notification: ATT_MTU - 3 */
-        const uint16_t max_mtu = bt_gatt_get_mtu(ble_conn) - 3;
+    struct ble_conn_ctx *ctx = user_data;
+
+    k_spinlock_key_t key = k_spin_lock(&notify_lock);
+    if (ctx->notify_queued > 0) {
+        ctx->notify_queued--;
+        notify_queued--;
+    }
+    k_spin_unlock(&notify_lock, key);
+
+    k_sem_give(&ctx->notify_credits);
+}
 
-        /* even max. possible size of 251 bytes should be OK to allocate on stack */
-        uint8_t chunk[max_mtu];
+/*
+ * Queue a notification in the Bluetooth stack. The data is copied by the stack, so the buffer
+ * can be reused immediately.
+ */
+static int notify_chunk(struct ble_conn_ctx *ctx, struct bt_conn *conn, const uint8_t *data,
+                        uint16_t len, k_timepoint_t end)
+{
+    struct bt_gatt_notify_params params = {
+        .attr = attr_ccc_req,
+        .data = data,
+        .len = len,
+        .func = notify_complete_cb,
+        .user_data = ctx,
+    };
+    int err;
+
+    /* backpressure: wait until a previous notification was sent */
+    if (k_sem_take(&ctx->notify_credits, sys_timepoint_timeout(end)) != 0) {
+        return -EBUSY;
+    }
 
-        int pos_buf = 0;
-        int chunk_len;
-        while ((chunk_len = packetize(buf, len, chunk, max_mtu, &pos_buf)) != 0) {
-            bt_gatt_notify(ble_conn, attr_ccc_req, chunk, chunk_len);
+    while ((err = bt_gatt_notify_cb(conn, &params)) == -ENOMEM) {
+        /* ACL buffers are shared with other traffic, so they may still be exhausted */
+        if (sys_timepoint_expired(end)) {
+            break;
         }
+        k_sleep(K_MSEC(1));
+    }
 
-        return 0;
+    if (err != 0) {
+        k_sem_give(&ctx->notify_credits);
+        return err;
     }
-    else {
+
+    k_spinlock_key_t key = k_spin_lock(&notify_lock);
+    ctx->notify_queued++;
+    notify_queued++;
+    k_spin_unlock(&notify_lock, key);
+
+    return 0;
+}
+
+/* send a message to a single connection */
+static int conn_ctx_send(struct ble_conn_ctx *ctx, const uint8_t *buf, size_t len)
+{
+    k_timepoint_t end = sys_timepoint_calc(K_MSEC(CONFIG_THINGSET_BLUETOOTH_NOTIFY_TIMEOUT_MS));
+
+    /* the whole message is sent before chunks of other threads are accepted */
+    if (k_mutex_lock(&ctx->tx_lock, sys_timepoint_timeout(end)) != 0) {
+        stats_inc(STATS_BLUETOOTH, STATS_TIMEOUTS);
+        return -EBUSY;
+    }
+
+    /*
+     * Only this reference is used, as ctx->conn may be cleared by a disconnect at any time, and
+     * notifications with a NULL connection would be sent to all Centrals.
+     */
+    struct bt_conn *conn = conn_ctx_ref(ctx);
+    if (conn == NULL || !bt_gatt_is_subscribed(conn, attr_ccc_req, BT_GATT_CCC_NOTIFY)) {
+        if (conn != NULL) {
+            bt_conn_unref(conn);
+        }
+        k_mutex_unlock(&ctx->tx_lock);
         return -EIO;
     }
+
+    /* Max. notification: ATT_MTU - 3 */
+    const uint16_t max_mtu = bt_gatt_get_mtu(conn) - 3;
+
+    /*
+     * Notifications need contiguous data, so the packetizer segments are gathered in a chunk
+     * buffer. Even max. possible size of 251 bytes should be OK to allocate on stack.
+     */
+    uint8_t chunk[max_mtu];
+    struct packet_segment segs[8];
+
+    int pos_buf = 0;
+    int err = 0;
+    while (pos_buf <= len) {
+        uint16_t chunk_len = 0;
+        int num;
+
+        /* escape sequences are never split, so the chunk never exceeds the MTU */
+        do {
+            num = packetize_segments(buf, len, segs, ARRAY_SIZE(segs), max_mtu - chunk_len,
+                                     &pos_buf);
+            for (int i = 0; i < num; i++) {
+                memcpy(chunk + chunk_len, segs[i].data, segs[i].len);
+                chunk_len += segs[i].len;
+            }
+        } while (num > 0);
+
+        err = notify_chunk(ctx, conn, chunk, chunk_len, end);
+        if (err != 0) {
+            /* the message can't be completed anymore, so the rest is discarded */
+            LOG_WRN("Notification failed (err %d), discarded rest of message", err);
+            k_spinlock_key_t key = k_spin_lock(&notify_lock);
+            notify_failed++;
+            k_spin_unlock(&notify_lock, key);
+            if (err == -EBUSY) {
+                stats_inc(STATS_BLUETOOTH, STATS_TIMEOUTS);
+            }
+            break;
+        }
+        stats_add(STATS_BLUETOOTH, STATS_BYTES_OUT, chunk_len);
+    }
+
+    bt_conn_unref(conn);
+    k_mutex_unlock(&ctx->tx_lock);
+
+    return err;
+}
+
+int thingset_bluetooth_send(const uint8_t *buf, size_t len)
+{
+    int ret = -EIO;
+
+    /* the message is encoded only once and notified to all subscribed connections */
+    for (int i = 0; i < ARRAY_SIZE(conn_ctxs); i++) {
+        if (conn_ctx_subscribed(&conn_ctxs[i])) {
+            int err = conn_ctx_send(&conn_ctxs[i], buf, len);
+            if (ret == -EIO || err != 0) {
+                ret = err;
+            }
+        }
+    }
+
+    return ret;
 }
 
 int thingset_bluetooth_send_report(const char *path)
 {
-    struct shared_buffer *tx_buf = thingset_sdk_shared_buffer();
-    k_sem_take(&tx_buf->lock, K_FOREVER);
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire_policy(
+        CONFIG_THINGSET_SHARED_TX_BUF_SIZE, THINGSET_SDK_TX_BUF_WAIT,
+        K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+    if (tx_buf == NULL) {
+        return -EBUSY;
+    }
 
     int len =
         thingset_report_path(&ts, tx_buf->data, tx_buf->size, path, THINGSET_TXT_NAMES_VALUES);
     int ret = thingset_bluetooth_send(tx_buf->data, len);
+    if (ret == 0) {
+        stats_inc(STATS_BLUETOOTH, STATS_REPORTS);
+    }
+
+    thingset_sdk_tx_buf_release(tx_buf);
+    return ret;
+}
+
+int thingset_bluetooth_send_report_handle(const struct thingset_report_handle *handle)
+{
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire_policy(
+        CONFIG_THINGSET_SHARED_TX_BUF_SIZE, THINGSET_SDK_TX_BUF_WAIT,
+        K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+    if (tx_buf == NULL) {
+        return -EBUSY;
+    }
+
+    int len = thingset_sdk_report_by_handle(handle, tx_buf->data, tx_buf->size,
+                                            THINGSET_TXT_NAMES_VALUES);
+    int ret = len > 0 ? thingset_bluetooth_send(tx_buf->data, len) : len;
+    if (ret == 0) {
+        stats_inc(STATS_BLUETOOTH, STATS_REPORTS);
+    }
 
-    k_sem_give(&tx_buf->lock);
+    thingset_sdk_tx_buf_release(tx_buf);
     return ret;
 }
 
 #ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
 
-static void regular_report_handler(struct k_work *work)
+static int report_sink_send(struct thingset_report_sink *sink, const uint8_t *buf, size_t len)
 {
-    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-    static int64_t pub_time;
-
-    if (live_reporting_enable) {
-        thingset_bluetooth_send_report(TS_NAME_SUBSET_LIVE);
+    int ret = thingset_bluetooth_send(buf, len);
+    if (ret == 0) {
+        stats_inc(STATS_BLUETOOTH, STATS_REPORTS);
+    }
+    else if (ret == -EIO) {
+        /* no Central subscribed, so nothing was lost */
+        return 0;
     }
 
-    pub_time += live_reporting_period;
-    thingset_sdk_reschedule_work(dwork, K_TIMEOUT_ABS_MS(pub_time));
+    return ret;
 }
 
+static struct thingset_report_sink report_sink = {
+    .format = THINGSET_TXT_NAMES_VALUES,
+    .send = report_sink_send,
+};
+
 #endif
 
 static void adv_work_handler(struct k_work *work)
 {
+    int num_conns = 0;
+
+    for (int i = 0; i < ARRAY_SIZE(conn_ctxs); i++) {
+        if (conn_ctxs[i].conn != NULL) {
+            num_conns++;
+        }
+    }
+
+    if (num_conns >= ARRAY_SIZE(conn_ctxs)) {
+        /* restarted after the next disconnect */
+        return;
+    }
+
     int err = bt_le_adv_start(BT_LE_ADV_CONN_FAST_1, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
-    if (err) {
+    if (err == -EALREADY) {
+        return;
+    }
+    else if (err) {
         LOG_ERR("Advertising failed to start (err %d)", err);
     }
     else {
@@ -238,30 +628,39 @@ static void adv_work_handler(struct k_work *work)
 
 static void process_msg_handler(struct k_work *work)
 {
-    if (rx_buf_pos > 0) {
-        LOG_DBG("Received Request (%d bytes): %s", rx_buf_pos, rx_buf);
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct ble_conn_ctx *ctx = CONTAINER_OF(dwork, struct ble_conn_ctx, processing_work);
+    uint32_t t_start = stats_timestamp();
+
+    if (ctx->rx_buf_pos > 0) {
+        LOG_DBG("Received Request (%d bytes): %s", ctx->rx_buf_pos, ctx->rx_buf);
+        stats_inc(STATS_BLUETOOTH, STATS_REQUESTS);
 
         if (rx_callback == NULL) {
-            struct shared_buffer *tx_buf = thingset_sdk_shared_buffer();
-            k_sem_take(&tx_buf->lock, K_FOREVER);
+            struct shared_buffer *tx_buf =
+                thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SHARED_TX_BUF_SIZE, K_FOREVER);
+
+            int len = thingset_sdk_process_message((uint8_t *)ctx->rx_buf, ctx->rx_buf_pos,
+                                                   tx_buf->data, tx_buf->size);
 
-            int len = thingset_process_message(&ts, (uint8_t *)rx_buf, rx_buf_pos, tx_buf->data,
-                                               tx_buf->size);
-            if (len > 0) {
-                thingset_bluetooth_send(tx_buf->data, len);
+            /* the response is only sent to the Central which sent the request */
+            if (len > 0 && conn_ctx_send(ctx, tx_buf->data, len) == 0) {
+                stats_inc(STATS_BLUETOOTH, STATS_RESPONSES);
             }
 
-            k_sem_give(&tx_buf->lock);
+            stats_record_latency(STATS_BLUETOOTH, ctx->rx_timestamp, t_start, stats_timestamp());
+
+            thingset_sdk_tx_buf_release(tx_buf);
         }
         else {
             /* external processing (e.g. for gateway applications) */
-            rx_callback(rx_buf, rx_buf_pos);
+            rx_callback(ctx->rx_buf, ctx->rx_buf_pos);
         }
     }
 
     // release buffer and start waiting for new commands
-    rx_buf_pos = 0;
-    k_sem_give(&rx_buf_lock);
+    ctx->rx_buf_pos = 0;
+    k_sem_give(&ctx->rx_buf_lock);
 }
 
 void thingset_bluetooth_set_rx_callback(thingset_sdk_rx_callback_t rx_cb)
@@ -271,13 +670,22 @@ void thingset_bluetooth_set_rx_callback(thingset_sdk_rx_callback_t rx_cb)
 
 static int thingset_bluetooth_init()
 {
-    k_sem_init(&rx_buf_lock, 1, 1);
+    for (int i = 0; i < ARRAY_SIZE(conn_ctxs); i++) {
+        struct ble_conn_ctx *ctx = &conn_ctxs[i];
+
+        k_sem_init(&ctx->rx_buf_lock, 1, 1);
+        k_mutex_init(&ctx->tx_lock);
+        k_sem_init(&ctx->notify_credits, CONFIG_THINGSET_BLUETOOTH_NOTIFY_IN_FLIGHT,
+                   CONFIG_THINGSET_BLUETOOTH_NOTIFY_IN_FLIGHT);
+        k_work_init_delayable(&ctx->processing_work, process_msg_handler);
+#ifdef CONFIG_THINGSET_BLUETOOTH_CONN_PARAMS_UPDATE
+        k_work_init_delayable(&ctx->params_work, conn_params_work_handler);
+#endif
+    }
+
+    bt_gatt_cb_register(&gatt_callbacks);
 
     k_work_init_delayable(&adv_work, adv_work_handler);
-    k_work_init_delayable(&processing_work, process_msg_handler);
-#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-    k_work_init_delayable(&reporting_work, regular_report_handler);
-#endif
 
     int err = bt_enable(NULL);
     if (err) {
@@ -285,10 +693,10 @@ static int thingset_bluetooth_init()
         return err;
     }
 
-    thingset_sdk_reschedule_work(&adv_work, K_NO_WAIT);
+    thingset_sdk_reschedule_work_prio(&adv_work, K_NO_WAIT, THINGSET_SDK_PRIO_BACKGROUND);
 
 #ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-    thingset_sdk_reschedule_work(&reporting_work, K_NO_WAIT);
+    thingset_sdk_register_report_sink(&report_sink);
 #endif
 
     return 0;
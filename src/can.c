@@ -18,6 +18,8 @@
 #include <thingset/sdk.h>
 #include <thingset/storage.h>
 
+#include "stats.h"
+
 LOG_MODULE_REGISTER(thingset_can, CONFIG_THINGSET_SDK_LOG_LEVEL);
 
 extern uint8_t eui64[8];
@@ -236,6 +238,7 @@ static void thingset_can_report_rx_cb(const struct device *dev, struct can_frame
             int chunk_len = can_dlc_to_bytes(frame->dlc);
             if (buffer->len + chunk_len > buffer->size) {
                 LOG_WRN("Discarded too large report from 0x%X", source_addr);
+                stats_inc(STATS_CAN, STATS_RX_DROPPED);
                 thingset_can_free_rx_buf(buffer);
                 return;
             }
@@ -255,6 +258,7 @@ static void thingset_can_report_rx_cb(const struct device *dev, struct can_frame
         else {
             /* out-of-sequence frame received, so free the buffer */
             LOG_WRN("Out-of-sequence frame received");
+            stats_inc(STATS_CAN, STATS_RX_DROPPED);
             thingset_can_free_rx_buf(buffer);
         }
     }
@@ -268,25 +272,17 @@ static void thingset_can_report_tx_cb(const struct device *dev, int error, void
     k_sem_give(&ts_can->report_tx_sem);
 }
 
-int thingset_can_send_report_inst(struct thingset_can *ts_can, const char *path,
-                                  enum thingset_data_format format)
+static int thingset_can_send_report_frames(struct thingset_can *ts_can, const uint8_t *buf,
+                                           size_t len)
 {
-    int len, ret = 0;
+    int ret = 0;
     int pos = 0;
     int chunk_len;
     uint8_t seq = 0;
     bool end = false;
 
-    struct shared_buffer *tx_buf = thingset_sdk_shared_buffer();
-    k_sem_take(&tx_buf->lock, K_FOREVER);
-
     k_sem_reset(&ts_can->report_tx_sem);
 
-    len = thingset_report_path(&ts, tx_buf->data, tx_buf->size, path, format);
-    if (len <= 0) {
-        goto out;
-    }
-
     struct can_frame frame = {
         .flags = CAN_FRAME_IDE | (IS_ENABLED(CONFIG_CAN_FD_MODE) ? CAN_FRAME_FDF : 0),
     };
@@ -302,7 +298,7 @@ int thingset_can_send_report_inst(struct thingset_can *ts_can, const char *path,
             end = true;
             mf_type = (pos == 0) ? THINGSET_CAN_MF_TYPE_SINGLE : THINGSET_CAN_MF_TYPE_LAST;
         }
-        memcpy(frame.data, tx_buf->data + pos, chunk_len);
+        memcpy(frame.data, buf + pos, chunk_len);
         frame.id = THINGSET_CAN_PRIO_REPORT_LOW | THINGSET_CAN_TYPE_MF_REPORT
                    | THINGSET_CAN_MSG_NO_SET(ts_can->msg_no) | mf_type
                    | THINGSET_CAN_SEQ_NO_SET(seq) | THINGSET_CAN_SOURCE_SET(ts_can->node_addr);
@@ -328,6 +324,7 @@ int thingset_can_send_report_inst(struct thingset_can *ts_can, const char *path,
         ret = k_sem_take(&ts_can->report_tx_sem, K_MSEC(100));
         if (ret != 0) {
             LOG_DBG("Sending CAN frame with ID 0x%X timed out", frame.id);
+            stats_inc(STATS_CAN, STATS_TIMEOUTS);
             break;
         }
 
@@ -339,28 +336,67 @@ int thingset_can_send_report_inst(struct thingset_can *ts_can, const char *path,
 
     ts_can->msg_no++;
 
-out:
-    k_sem_give(&tx_buf->lock);
+    stats_add(STATS_CAN, STATS_BYTES_OUT, pos);
+    if (ret == 0) {
+        stats_inc(STATS_CAN, STATS_REPORTS);
+    }
+
     return ret;
 }
 
-#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-static void thingset_can_live_reporting_handler(struct k_work *work)
+int thingset_can_send_report_inst(struct thingset_can *ts_can, const char *path,
+                                  enum thingset_data_format format)
 {
-    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-    struct thingset_can *ts_can = CONTAINER_OF(dwork, struct thingset_can, live_reporting_work);
+    int len, ret = 0;
+
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire_policy(
+        CONFIG_THINGSET_SHARED_TX_BUF_SIZE, THINGSET_SDK_TX_BUF_WAIT,
+        K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+    if (tx_buf == NULL) {
+        return -EBUSY;
+    }
+
+    len = thingset_report_path(&ts, tx_buf->data, tx_buf->size, path, format);
+    if (len > 0) {
+        ret = thingset_can_send_report_frames(ts_can, tx_buf->data, len);
+    }
+
+    thingset_sdk_tx_buf_release(tx_buf);
+    return ret;
+}
 
-    if (live_reporting_enable) {
-        thingset_can_send_report_inst(ts_can, TS_NAME_SUBSET_LIVE, THINGSET_BIN_IDS_VALUES);
+int thingset_can_send_report_handle_inst(struct thingset_can *ts_can,
+                                         const struct thingset_report_handle *handle,
+                                         enum thingset_data_format format)
+{
+    int len, ret = 0;
+
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire_policy(
+        CONFIG_THINGSET_SHARED_TX_BUF_SIZE, THINGSET_SDK_TX_BUF_WAIT,
+        K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+    if (tx_buf == NULL) {
+        return -EBUSY;
     }
 
-    ts_can->next_live_report_time += live_reporting_period;
-    if (ts_can->next_live_report_time <= k_uptime_get()) {
-        /* ensure proper initialization of next_live_report_time */
-        ts_can->next_live_report_time = k_uptime_get() + live_reporting_period;
+    len = thingset_sdk_report_by_handle(handle, tx_buf->data, tx_buf->size, format);
+    if (len > 0) {
+        ret = thingset_can_send_report_frames(ts_can, tx_buf->data, len);
+    }
+    else if (len < 0) {
+        ret = len;
     }
 
-    thingset_sdk_reschedule_work(dwork, K_TIMEOUT_ABS_MS(ts_can->next_live_report_time));
+    thingset_sdk_tx_buf_release(tx_buf);
+    return ret;
+}
+
+#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
+static int thingset_can_live_report_sink_send(struct thingset_report_sink *sink,
+                                              const uint8_t *buf, size_t len)
+{
+    struct thingset_can *ts_can = CONTAINER_OF(sink, struct thingset_can, live_report_sink);
+
+    return thingset_can_send_report_frames(ts_can, buf, len);
 }
 #endif /* CONFIG_THINGSET_SUBSET_LIVE_METRICS */
 
@@ -370,32 +406,37 @@ static void thingset_can_item_tx_cb(const struct device *dev, int error, void *u
     /* Do nothing: Single-frame reports are fire and forget. */
 }
 
-static void thingset_can_control_reporting_handler(struct k_work *work)
+static void thingset_can_control_reporting_handler(struct thingset_report_job *job)
 {
-    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-    struct thingset_can *ts_can = CONTAINER_OF(dwork, struct thingset_can, control_reporting_work);
+    struct thingset_can *ts_can = CONTAINER_OF(job, struct thingset_can, control_reporting_job);
     int data_len = 0;
     int err;
 
     struct can_frame frame = {
         .flags = CAN_FRAME_IDE,
     };
-    struct shared_buffer *sbuf = thingset_sdk_shared_buffer();
+    struct shared_buffer *sbuf;
 
     struct thingset_data_object *obj = NULL;
     while (ts_can->control_enable
            && (obj = thingset_iterate_subsets(&ts, CONFIG_THINGSET_CAN_CONTROL_SUBSET, obj))
                   != NULL)
     {
-        k_sem_take(&sbuf->lock, K_FOREVER);
+        /* values exceeding a CAN frame are discarded anyway, so any pool buffer is sufficient */
+        sbuf = thingset_sdk_tx_buf_acquire_policy(CAN_MAX_DLEN + 1, THINGSET_SDK_TX_BUF_SKIP,
+                                                  K_NO_WAIT);
+        if (sbuf == NULL) {
+            /* control values are sent again in the next period */
+            break;
+        }
         data_len = thingset_export_item(&ts, sbuf->data, sbuf->size, obj, THINGSET_BIN_VALUES_ONLY);
         if (data_len > CAN_MAX_DLEN) {
             LOG_WRN("Value of data item %x exceeds single CAN frame payload size", obj->id);
-            k_sem_give(&sbuf->lock);
+            thingset_sdk_tx_buf_release(sbuf);
         }
         else if (data_len > 0) {
             memcpy(frame.data, sbuf->data, data_len);
-            k_sem_give(&sbuf->lock);
+            thingset_sdk_tx_buf_release(sbuf);
             frame.id = THINGSET_CAN_TYPE_SF_REPORT | THINGSET_CAN_PRIO_CONTROL_LOW
                        | THINGSET_CAN_DATA_ID_SET(obj->id)
                        | THINGSET_CAN_SOURCE_SET(ts_can->node_addr);
@@ -413,18 +454,10 @@ static void thingset_can_control_reporting_handler(struct k_work *work)
 #endif
         }
         else {
-            k_sem_give(&sbuf->lock);
+            thingset_sdk_tx_buf_release(sbuf);
         }
         obj++; /* continue with object behind current one */
     }
-
-    ts_can->next_control_report_time += ts_can->control_period;
-    if (ts_can->next_control_report_time <= k_uptime_get()) {
-        /* ensure proper initialization of next_control_report_time */
-        ts_can->next_control_report_time = k_uptime_get() + ts_can->control_period;
-    }
-
-    thingset_sdk_reschedule_work(dwork, K_TIMEOUT_ABS_MS(ts_can->next_control_report_time));
 }
 #endif
 
@@ -460,10 +493,10 @@ static void thingset_can_reqresp_timeout_handler(struct k_timer *timer)
     thingset_can_reset_request_response(rr);
 }
 
-int thingset_can_send_inst(struct thingset_can *ts_can, uint8_t *tx_buf, size_t tx_len,
-                           uint8_t target_addr, uint8_t route,
-                           thingset_can_reqresp_callback_t callback, void *callback_arg,
-                           k_timeout_t timeout)
+static int thingset_can_send_msg(struct thingset_can *ts_can, enum thingset_can_tx_type type,
+                                 uint8_t *tx_buf, size_t tx_len, uint8_t target_addr,
+                                 uint8_t route, thingset_can_reqresp_callback_t callback,
+                                 void *callback_arg, k_timeout_t timeout)
 {
     if (!device_is_ready(ts_can->dev)) {
         return -ENODEV;
@@ -482,6 +515,7 @@ int thingset_can_send_inst(struct thingset_can *ts_can, uint8_t *tx_buf, size_t
 
     if (callback != NULL) {
         if (k_sem_take(&ts_can->request_response.sem, timeout) != 0) {
+            stats_inc(STATS_CAN, STATS_TIMEOUTS);
             return -ETIMEDOUT;
         }
 
@@ -492,9 +526,11 @@ int thingset_can_send_inst(struct thingset_can *ts_can, uint8_t *tx_buf, size_t
         ts_can->request_response.can_id = thingset_can_get_tx_addr(&tx_addr).ext_id;
     }
 
-    int ret = isotp_fast_send(&ts_can->ctx, tx_buf, tx_len, tx_addr, ts_can);
+    /* the sent callback needs to know which message finished, so the type is passed along */
+    int ret = isotp_fast_send(&ts_can->ctx, tx_buf, tx_len, tx_addr, &ts_can->tx_ctx[type]);
 
     if (ret == ISOTP_N_OK) {
+        stats_add(STATS_CAN, STATS_BYTES_OUT, tx_len);
         return 0;
     }
     else {
@@ -503,17 +539,44 @@ int thingset_can_send_inst(struct thingset_can *ts_can, uint8_t *tx_buf, size_t
     }
 }
 
+int thingset_can_send_inst(struct thingset_can *ts_can, uint8_t *tx_buf, size_t tx_len,
+                           uint8_t target_addr, uint8_t route,
+                           thingset_can_reqresp_callback_t callback, void *callback_arg,
+                           k_timeout_t timeout)
+{
+    enum thingset_can_tx_type type =
+        (callback != NULL) ? THINGSET_CAN_TX_REQUEST : THINGSET_CAN_TX_MESSAGE;
+
+    return thingset_can_send_msg(ts_can, type, tx_buf, tx_len, target_addr, route, callback,
+                                 callback_arg, timeout);
+}
+
+static void thingset_can_release_rsp_buf(struct thingset_can *ts_can)
+{
+    struct shared_buffer *sbuf = ts_can->rsp_buf;
+
+    /* single-frame responses may already have been released synchronously by the sent callback */
+    ts_can->rsp_buf = NULL;
+    if (sbuf != NULL) {
+        thingset_sdk_tx_buf_release(sbuf);
+        k_sem_give(&ts_can->rsp_lock);
+    }
+}
+
 static void thingset_can_reqresp_recv_callback(struct net_buf *buffer, int rem_len,
                                                struct isotp_fast_addr addr, void *arg)
 {
     struct thingset_can *ts_can = arg;
+    uint32_t t_arrival = stats_timestamp();
 
     if (rem_len < 0) {
         LOG_ERR("RX error %d", rem_len);
+        stats_inc(STATS_CAN, STATS_RX_DROPPED);
     }
 
     if (rem_len == 0) {
         size_t len = net_buf_frags_len(buffer);
+        stats_add(STATS_CAN, STATS_BYTES_IN, len);
         net_buf_linearize(ts_can->rx_buffer, sizeof(ts_can->rx_buffer), buffer, 0, len);
         if (ts_can->request_response.callback != NULL
             && ts_can->request_response.can_id == addr.ext_id)
@@ -524,23 +587,33 @@ static void thingset_can_reqresp_recv_callback(struct net_buf *buffer, int rem_l
             thingset_can_reset_request_response(&ts_can->request_response);
         }
         else {
-            struct shared_buffer *sbuf = thingset_sdk_shared_buffer();
-            k_sem_take(&sbuf->lock, K_FOREVER);
+            /* only one response per instance in flight, released again in sent callback */
+            stats_inc(STATS_CAN, STATS_REQUESTS);
+            k_sem_take(&ts_can->rsp_lock, K_FOREVER);
+            struct shared_buffer *sbuf =
+                thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SHARED_TX_BUF_SIZE, K_FOREVER);
+            ts_can->rsp_buf = sbuf;
+            uint32_t t_start = stats_timestamp();
             int tx_len =
-                thingset_process_message(&ts, ts_can->rx_buffer, len, sbuf->data, sbuf->size);
+                thingset_sdk_process_message(ts_can->rx_buffer, len, sbuf->data, sbuf->size);
             if (tx_len > 0) {
                 uint8_t target_addr = THINGSET_CAN_SOURCE_GET(addr.ext_id);
                 uint8_t route = IS_ENABLED(CONFIG_THINGSET_CAN_ROUTING_BUSES)
                                     ? THINGSET_CAN_SOURCE_BUS_GET(addr.ext_id)
                                     : THINGSET_CAN_BRIDGE_GET(addr.ext_id);
-                int err = thingset_can_send_inst(ts_can, sbuf->data, tx_len, target_addr, route,
-                                                 NULL, NULL, K_NO_WAIT);
-                if (err != 0) {
-                    k_sem_give(&sbuf->lock);
+                int err = thingset_can_send_msg(ts_can, THINGSET_CAN_TX_RESPONSE, sbuf->data,
+                                                tx_len, target_addr, route, NULL, NULL,
+                                                K_NO_WAIT);
+                if (err == 0) {
+                    stats_inc(STATS_CAN, STATS_RESPONSES);
+                }
+                else {
+                    thingset_can_release_rsp_buf(ts_can);
                 }
+                stats_record_latency(STATS_CAN, t_arrival, t_start, stats_timestamp());
             }
             else {
-                k_sem_give(&sbuf->lock);
+                thingset_can_release_rsp_buf(ts_can);
             }
         }
     }
@@ -550,25 +623,34 @@ static void thingset_can_reqresp_recv_error_callback(int8_t error, struct isotp_
                                                      void *arg)
 {
     LOG_ERR("RX error %d", error);
+    stats_inc(STATS_CAN, STATS_RX_DROPPED);
 }
 
 static void thingset_can_reqresp_sent_callback(int result, void *arg)
 {
-    struct thingset_can *ts_can = arg;
-    if (ts_can->request_response.callback != NULL) {
-        ts_can->request_response.callback(NULL, 0, 0, result,
-                                          THINGSET_CAN_SOURCE_GET(ts_can->request_response.can_id),
-                                          ts_can->request_response.cb_arg);
-        thingset_can_reset_request_response(&ts_can->request_response);
-        if (result == 0) {
-            /* maintain unlocking semantics of previous iteration of this code */
-            struct shared_buffer *sbuf = thingset_sdk_shared_buffer();
-            k_sem_give(&sbuf->lock);
-        }
-    }
-    else {
-        struct shared_buffer *sbuf = thingset_sdk_shared_buffer();
-        k_sem_give(&sbuf->lock);
+    struct thingset_can_tx_ctx *tx_ctx = arg;
+    struct thingset_can *ts_can = tx_ctx->ts_can;
+
+    switch (tx_ctx->type) {
+        case THINGSET_CAN_TX_RESPONSE:
+            thingset_can_release_rsp_buf(ts_can);
+            break;
+        case THINGSET_CAN_TX_REQUEST:
+            /* the request may have timed out already */
+            if (ts_can->request_response.callback != NULL) {
+                ts_can->request_response.callback(
+                    NULL, 0, 0, result, THINGSET_CAN_SOURCE_GET(ts_can->request_response.can_id),
+                    ts_can->request_response.cb_arg);
+                thingset_can_reset_request_response(&ts_can->request_response);
+            }
+            if (result == 0) {
+                /* maintain unlocking semantics of previous iteration of this code */
+                k_sem_give(&thingset_sdk_shared_buffer()->lock);
+            }
+            break;
+        default:
+            k_sem_give(&thingset_sdk_shared_buffer()->lock);
+            break;
     }
 }
 
@@ -599,15 +681,24 @@ int thingset_can_init_inst(struct thingset_can *ts_can, const struct device *can
 #endif
     k_sem_init(&ts_can->request_response.sem, 1, 1);
     k_sem_init(&ts_can->report_tx_sem, 0, 1);
+    k_sem_init(&ts_can->rsp_lock, 1, 1);
+    for (int i = 0; i < ARRAY_SIZE(ts_can->tx_ctx); i++) {
+        ts_can->tx_ctx[i].ts_can = ts_can;
+        ts_can->tx_ctx[i].type = i;
+    }
     k_timer_init(&ts_can->timeout_timer, thingset_can_timeout_timer_expired, NULL);
 
 #ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-    k_work_init_delayable(&ts_can->live_reporting_work, thingset_can_live_reporting_handler);
+    ts_can->live_report_sink.format = THINGSET_BIN_IDS_VALUES;
+    ts_can->live_report_sink.send = thingset_can_live_report_sink_send;
 #endif
 #ifdef CONFIG_THINGSET_CAN_CONTROL_REPORTING
     ts_can->control_enable = IS_ENABLED(CONFIG_THINGSET_CAN_CONTROL_REPORTING_ENABLE_PRESET);
     ts_can->control_period = CONFIG_THINGSET_CAN_CONTROL_REPORTING_PERIOD;
-    k_work_init_delayable(&ts_can->control_reporting_work, thingset_can_control_reporting_handler);
+    ts_can->control_reporting_job.fn = thingset_can_control_reporting_handler;
+    ts_can->control_reporting_job.period = &ts_can->control_period;
+    ts_can->control_reporting_job.period_unit_ms = 1;
+    ts_can->control_reporting_job.prio = THINGSET_SDK_PRIO_HIGH;
 #endif
     k_work_init_delayable(&ts_can->addr_claim_work, thingset_can_addr_claim_tx_handler);
 
@@ -766,10 +857,10 @@ int thingset_can_init_inst(struct thingset_can *ts_can, const struct device *can
                     thingset_can_reqresp_sent_callback);
 
 #ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-    thingset_sdk_reschedule_work(&ts_can->live_reporting_work, K_NO_WAIT);
+    thingset_sdk_register_report_sink(&ts_can->live_report_sink);
 #endif
 #ifdef CONFIG_THINGSET_CAN_CONTROL_REPORTING
-    thingset_sdk_reschedule_work(&ts_can->control_reporting_work, K_NO_WAIT);
+    thingset_sdk_report_job_start(&ts_can->control_reporting_job);
 #endif
 
     return 0;
@@ -854,6 +945,12 @@ int thingset_can_send_report(const char *path, enum thingset_data_format format)
     return thingset_can_send_report_inst(&ts_can_single, path, format);
 }
 
+int thingset_can_send_report_handle(const struct thingset_report_handle *handle,
+                                    enum thingset_data_format format)
+{
+    return thingset_can_send_report_handle_inst(&ts_can_single, handle, format);
+}
+
 int thingset_can_send(uint8_t *tx_buf, size_t tx_len, uint8_t target_addr, uint8_t route,
                       thingset_can_reqresp_callback_t callback, void *callback_arg,
                       k_timeout_t timeout)
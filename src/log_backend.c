@@ -26,6 +26,9 @@ static uint8_t log_level;
 static bool pub_logs_enable;
 static uint8_t max_level;
 
+/* resolved before the backend is enabled, as the data objects are initialized after logging */
+static struct thingset_report_handle log_report;
+
 THINGSET_ADD_GROUP(TS_ID_ROOT, TS_ID_LOG, "Log", THINGSET_NO_CALLBACK);
 
 #ifdef CONFIG_THINGSET_LOG_BACKEND_USE_UPTIME
@@ -115,10 +118,10 @@ static void process(const struct log_backend *const backend, union log_msg_gener
 
     /* ToDo: Implement rate limit to avoid congestion */
 #ifdef CONFIG_THINGSET_SERIAL
-    thingset_serial_send_report("Log");
+    thingset_serial_send_report_handle(&log_report);
 #endif
 #ifdef CONFIG_THINGSET_BLUETOOTH
-    thingset_bluetooth_send_report("Log");
+    thingset_bluetooth_send_report_handle(&log_report);
 #endif
 }
 
@@ -132,4 +135,18 @@ static const struct log_backend_api log_backend_thingset_api = {
     .panic = panic,
 };
 
-LOG_BACKEND_DEFINE(log_backend_thingset, log_backend_thingset_api, true);
+LOG_BACKEND_DEFINE(log_backend_thingset, log_backend_thingset_api, false);
+
+static int log_backend_thingset_init(void)
+{
+    int err = thingset_sdk_report_handle_init_by_id(&log_report, TS_ID_LOG);
+    if (err != 0) {
+        return err;
+    }
+
+    log_backend_enable(&log_backend_thingset, NULL, CONFIG_LOG_MAX_LEVEL);
+
+    return 0;
+}
+
+SYS_INIT(log_backend_thingset_init, APPLICATION, THINGSET_INIT_PRIORITY_DEFAULT);
@@ -23,6 +23,10 @@ BUILD_ASSERT(DT_NODE_HAS_STATUS(LORA_RADIO_NODE, okay), "No LoRa radio specified
 
 static uint8_t tx_buf[51];
 
+/* given by the SDK report scheduler, as the LoRaWAN stack has to be used from this thread */
+static K_SEM_DEFINE(summary_report_sem, 0, 1);
+static struct thingset_report_job summary_report_job;
+
 char lorawan_join_eui[8 * 2 + 1] = "0000000000000000";
 char lorawan_app_key[16 * 2 + 1] = "";
 uint32_t lorawan_dev_nonce;
@@ -71,6 +75,11 @@ static void downlink_callback(uint8_t port, uint8_t flags, int16_t rssi, int8_t
     }
 }
 
+static void summary_report_trigger(struct thingset_report_job *job)
+{
+    k_sem_give(&summary_report_sem);
+}
+
 static void datarate_changed(enum lorawan_datarate dr)
 {
     uint8_t unused, max_size;
@@ -109,6 +118,12 @@ void lorawan_thread(void)
     // previous dev_nonce read from EEPROM must be increased for new join
     lorawan_dev_nonce++;
 
+    summary_report_job.fn = summary_report_trigger;
+    summary_report_job.period = &summary_reporting_period;
+    summary_report_job.period_unit_ms = MSEC_PER_SEC;
+    summary_report_job.prio = THINGSET_SDK_PRIO_BACKGROUND;
+    thingset_sdk_report_job_start(&summary_report_job);
+
     join_cfg.mode = LORAWAN_ACT_OTAA;
     join_cfg.dev_eui = eui64;
     join_cfg.otaa.join_eui = join_eui;
@@ -183,7 +198,7 @@ void lorawan_thread(void)
             LOG_HEXDUMP_INF(tx_buf, len, "Message sent: ");
         }
 
-        k_sleep(K_MSEC(summary_reporting_period * 1000));
+        k_sem_take(&summary_report_sem, K_FOREVER);
     }
 }
 
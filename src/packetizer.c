@@ -5,6 +5,46 @@
  */
 #include "packetizer.h"
 
+#include <string.h>
+
+/*
+ * Word-at-a-time (SWAR) search for the special bytes: XOR with the byte value repeated in each
+ * lane turns matching bytes into zero bytes, which are detected without branching per byte.
+ */
+typedef uintptr_t swar_word_t;
+
+#define SWAR_ONES  ((swar_word_t)-1 / 0xFF)
+#define SWAR_HIGHS (SWAR_ONES * 0x80)
+
+#define SWAR_HAS_ZERO(w)    (((w) - SWAR_ONES) & ~(w) & SWAR_HIGHS)
+#define SWAR_HAS_BYTE(w, b) SWAR_HAS_ZERO((w) ^ (SWAR_ONES * (b)))
+
+static inline bool is_special(uint8_t c)
+{
+    return c == MSG_END || c == MSG_SKIP || c == MSG_ESC;
+}
+
+/* number of bytes at the beginning of buf which don't need to be escaped (max. len) */
+static size_t clean_run_len(const uint8_t *buf, size_t len)
+{
+    size_t i = 0;
+
+    for (; i + sizeof(swar_word_t) <= len; i += sizeof(swar_word_t)) {
+        swar_word_t w;
+        memcpy(&w, buf + i, sizeof(w));
+        if (SWAR_HAS_BYTE(w, MSG_END) || SWAR_HAS_BYTE(w, MSG_SKIP) || SWAR_HAS_BYTE(w, MSG_ESC)) {
+            break;
+        }
+    }
+
+    /* remaining bytes and the word containing a special byte */
+    while (i < len && !is_special(buf[i])) {
+        i++;
+    }
+
+    return i;
+}
+
 int packetize(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len, int *src_pos)
 {
     int pos_buf = *src_pos;
@@ -14,6 +54,20 @@ int packetize(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len,
     }
 
     while (pos_chunk < dst_len && pos_buf < src_len) {
+        size_t max_run = src_len - pos_buf;
+        if (max_run > dst_len - pos_chunk) {
+            max_run = dst_len - pos_chunk;
+        }
+
+        /* bytes without escaping are copied in one go */
+        size_t run = clean_run_len(src + pos_buf, max_run);
+        if (run > 0) {
+            memcpy(dst + pos_chunk, src + pos_buf, run);
+            pos_chunk += run;
+            pos_buf += run;
+            continue;
+        }
+
         if (src[pos_buf] == MSG_END) {
             dst[pos_chunk++] = MSG_ESC;
             dst[pos_chunk++] = MSG_ESC_END;
@@ -22,13 +76,10 @@ int packetize(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len,
             dst[pos_chunk++] = MSG_ESC;
             dst[pos_chunk++] = MSG_ESC_SKIP;
         }
-        else if (src[pos_buf] == MSG_ESC) {
+        else {
             dst[pos_chunk++] = MSG_ESC;
             dst[pos_chunk++] = MSG_ESC_ESC;
         }
-        else {
-            dst[pos_chunk++] = src[pos_buf];
-        }
         pos_buf++;
     }
     if (pos_chunk < dst_len - 1 && pos_buf == src_len) {
@@ -40,12 +91,89 @@ int packetize(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len,
     return pos_chunk;
 }
 
+static const uint8_t seq_end[] = { MSG_END };
+static const uint8_t seq_esc_end[] = { MSG_ESC, MSG_ESC_END };
+static const uint8_t seq_esc_skip[] = { MSG_ESC, MSG_ESC_SKIP };
+static const uint8_t seq_esc_esc[] = { MSG_ESC, MSG_ESC_ESC };
+
+int packetize_segments(const uint8_t *src, size_t src_len, struct packet_segment *segs,
+                       size_t num_segs, size_t max_len, int *src_pos)
+{
+    int pos_buf = *src_pos;
+    int num = 0;
+
+    if (pos_buf == 0) {
+        /* start byte is only emitted together with the first data segment */
+        if (num_segs < 2 || max_len < 3) {
+            return 0;
+        }
+        segs[num].data = seq_end;
+        segs[num++].len = sizeof(seq_end);
+        max_len -= sizeof(seq_end);
+    }
+
+    while (num < num_segs && pos_buf < src_len) {
+        size_t max_run = src_len - pos_buf;
+        if (max_run > max_len) {
+            max_run = max_len;
+        }
+
+        size_t run = clean_run_len(src + pos_buf, max_run);
+        if (run > 0) {
+            segs[num].data = src + pos_buf;
+            segs[num++].len = run;
+            max_len -= run;
+            pos_buf += run;
+            continue;
+        }
+
+        if (max_len < 2) {
+            break;
+        }
+
+        if (src[pos_buf] == MSG_END) {
+            segs[num].data = seq_esc_end;
+        }
+        else if (src[pos_buf] == MSG_SKIP) {
+            segs[num].data = seq_esc_skip;
+        }
+        else {
+            segs[num].data = seq_esc_esc;
+        }
+        segs[num++].len = 2;
+        max_len -= 2;
+        pos_buf++;
+    }
+    if (num < num_segs && max_len > 0 && pos_buf == src_len) {
+        segs[num].data = seq_end;
+        segs[num++].len = sizeof(seq_end);
+        pos_buf++;
+    }
+
+    (*src_pos) = pos_buf;
+    return num;
+}
+
 bool reassemble(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len, int *dst_pos,
                 bool *escape)
 {
     bool finished = true;
-    for (int i = 0; i < src_len; i++) {
-        uint8_t c = *(src + i);
+    size_t i = 0;
+
+    while (i < src_len) {
+        if (!(*escape)) {
+            /* bytes without special meaning are copied in one go */
+            size_t run = clean_run_len(src + i, src_len - i);
+            if (run > 0) {
+                memcpy(dst + *dst_pos, src + i, run);
+                (*dst_pos) += run;
+                i += run;
+                finished = false;
+                continue;
+            }
+        }
+
+        uint8_t c = src[i++];
         if (*escape) {
             if (c == MSG_ESC_END) {
                 c = MSG_END;
@@ -76,9 +204,6 @@ bool reassemble(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len
                 return finished;
             }
         }
-        else {
-            finished = false;
-        }
         dst[(*dst_pos)++] = c;
     }
 
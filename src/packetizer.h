@@ -45,3 +45,33 @@ int packetize(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len,
  */
 bool reassemble(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len, int *dst_pos,
                 bool *escape);
+
+/**
+ * Part of a packetized message, either referencing the source buffer or a constant escape
+ * sequence or frame delimiter.
+ */
+struct packet_segment
+{
+    const uint8_t *data;
+    size_t len;
+};
+
+/**
+ * Split the supplied source buffer into segments like packetize(), but without copying the
+ * data. Runs of bytes which don't need escaping reference the source buffer directly, so the
+ * source buffer must stay valid until all segments have been consumed. Escape sequences are
+ * never split between two calls. Call this method until it returns 0.
+ *
+ * @param src The source buffer.
+ * @param src_len The size of the source buffer.
+ * @param segs Array to store the segments.
+ * @param num_segs Number of elements in segs (at least 2 to make progress at the frame start).
+ * @param max_len Maximum total length of the returned segments (at least 3 to make progress).
+ * @param src_pos A pointer to the current position in the source buffer.
+ *
+ * @returns The number of segments stored in segs. When this is 0 and src_pos is greater than
+ * src_len, the source buffer has been completely read. Otherwise the segments didn't fit into
+ * max_len.
+ */
+int packetize_segments(const uint8_t *src, size_t src_len, struct packet_segment *segs,
+                       size_t num_segs, size_t max_len, int *src_pos);
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) The ThingSet Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <thingset.h>
+#include <thingset/sdk.h>
+
+#include "report.h"
+
+LOG_MODULE_REGISTER(thingset_report, CONFIG_THINGSET_SDK_LOG_LEVEL);
+
+/* function code of ThingSet reports in binary mode */
+#define BIN_REPORT 0x1F
+
+/* maximum length of the path of objects initialized by ID */
+#define PATH_MAX_LEN 64
+
+int report_cbor_encode_head(uint8_t *buf, size_t size, uint8_t major, uint32_t value)
+{
+    if (value < 24 && size >= 1) {
+        buf[0] = major | value;
+        return 1;
+    }
+    else if (value <= UINT8_MAX && size >= 2) {
+        buf[0] = major | 24;
+        buf[1] = value;
+        return 2;
+    }
+    else if (value <= UINT16_MAX && size >= 3) {
+        buf[0] = major | 25;
+        sys_put_be16(value, &buf[1]);
+        return 3;
+    }
+    else if (value > UINT16_MAX && size >= 5) {
+        buf[0] = major | 26;
+        sys_put_be32(value, &buf[1]);
+        return 5;
+    }
+
+    return -ENOMEM;
+}
+
+int report_get_path(char *buf, size_t size, const struct thingset_data_object *obj)
+{
+    int pos = 0;
+
+    if (obj->parent_id != TS_ID_ROOT) {
+        struct thingset_data_object *parent = thingset_get_object_by_id(&ts, obj->parent_id);
+        if (parent != NULL) {
+            pos = report_get_path(buf, size, parent);
+            if (pos < 0 || pos + 1 >= size) {
+                return -ENOMEM;
+            }
+            buf[pos++] = '/';
+        }
+    }
+
+    int len = snprintf(buf + pos, size - pos, "%s", obj->name);
+    if (len < 0 || pos + len >= size) {
+        return -ENOMEM;
+    }
+
+    return pos + len;
+}
+
+static int cbor_encode_text(uint8_t *buf, size_t size, const char *str, size_t len)
+{
+    int pos = report_cbor_encode_head(buf, size, CBOR_TEXT, len);
+    if (pos < 0 || pos + len > size) {
+        return -ENOMEM;
+    }
+
+    memcpy(buf + pos, str, len);
+
+    return pos + len;
+}
+
+int report_encode_header(uint8_t *buf, size_t size, const struct thingset_report_handle *handle,
+                         enum thingset_data_format format)
+{
+    char path_buf[PATH_MAX_LEN];
+    const char *path = handle->path;
+    int path_len = 0;
+    int len;
+
+    if (format == THINGSET_TXT_NAMES_VALUES || format == THINGSET_BIN_NAMES_VALUES) {
+        if (path != NULL) {
+            path_len = strlen(path);
+        }
+        else {
+            path_len = report_get_path(path_buf, sizeof(path_buf), handle->obj);
+            if (path_len < 0) {
+                return path_len;
+            }
+            path = path_buf;
+        }
+    }
+
+    if (format == THINGSET_TXT_NAMES_VALUES) {
+        len = snprintf((char *)buf, size, "#%.*s ", path_len, path);
+        return (len >= 0 && len < size) ? len : -ENOMEM;
+    }
+
+    if (size < 1) {
+        return -ENOMEM;
+    }
+    buf[0] = BIN_REPORT;
+
+    if (format == THINGSET_BIN_NAMES_VALUES) {
+        len = cbor_encode_text(buf + 1, size - 1, path, path_len);
+    }
+    else {
+        len = report_cbor_encode_head(buf + 1, size - 1, CBOR_UINT, handle->obj->id);
+    }
+
+    return len < 0 ? len : len + 1;
+}
+
+/*
+ * Groups are reported via the library, as their children (e.g. subgroups or functions) need the
+ * same treatment as for a request. Only the path lookup is avoided for top-level groups.
+ */
+static int report_group(const struct thingset_report_handle *handle, uint8_t *buf, size_t size,
+                        enum thingset_data_format format)
+{
+    char path_buf[PATH_MAX_LEN];
+    const char *path = handle->path;
+
+    if (path == NULL) {
+        int len = report_get_path(path_buf, sizeof(path_buf), handle->obj);
+        if (len < 0) {
+            return len;
+        }
+        path = path_buf;
+    }
+
+    return thingset_report_path(&ts, buf, size, path, format);
+}
+
+int thingset_sdk_report_handle_init(struct thingset_report_handle *handle, const char *path)
+{
+    int index;
+
+    handle->obj = thingset_get_object_by_path(&ts, path, strlen(path), &index);
+    if (handle->obj == NULL) {
+        LOG_ERR("Object %s for report not found", path);
+        return -ENOENT;
+    }
+
+    handle->path = path;
+
+    return 0;
+}
+
+int thingset_sdk_report_handle_init_by_id(struct thingset_report_handle *handle, uint16_t id)
+{
+    handle->obj = thingset_get_object_by_id(&ts, id);
+    if (handle->obj == NULL) {
+        LOG_ERR("Object 0x%X for report not found", id);
+        return -ENOENT;
+    }
+
+    /* the path of top-level objects is known already, all others are generated if needed */
+    handle->path = (handle->obj->parent_id == TS_ID_ROOT) ? handle->obj->name : NULL;
+
+    return 0;
+}
+
+int thingset_sdk_report_by_handle(const struct thingset_report_handle *handle, uint8_t *buf,
+                                  size_t size, enum thingset_data_format format)
+{
+    const struct thingset_data_object *obj = handle->obj;
+    int pos, len;
+
+    if (obj == NULL) {
+        return -EINVAL;
+    }
+
+    if (obj->type == THINGSET_TYPE_GROUP) {
+        return report_group(handle, buf, size, format);
+    }
+
+    pos = report_encode_header(buf, size, handle, format);
+    if (pos < 0) {
+        return pos;
+    }
+
+    switch (obj->type) {
+        case THINGSET_TYPE_SUBSET:
+            len = thingset_export_subsets(&ts, buf + pos, size - pos, obj->data.subset, format);
+            break;
+        default:
+            len = thingset_export_item(&ts, buf + pos, size - pos, obj,
+                                       format == THINGSET_TXT_NAMES_VALUES
+                                           ? THINGSET_TXT_NAMES_VALUES
+                                           : THINGSET_BIN_VALUES_ONLY);
+            break;
+    }
+
+    if (len < 0) {
+        return len;
+    }
+
+    return pos + len;
+}
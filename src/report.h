@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) The ThingSet Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef THINGSET_REPORT_H_
+#define THINGSET_REPORT_H_
+
+#include <stdint.h>
+
+#include <thingset.h>
+#include <thingset/sdk.h>
+
+/* CBOR major types used for encoding of reports */
+#define CBOR_UINT   (0U << 5)
+#define CBOR_NEGINT (1U << 5)
+#define CBOR_TEXT   (3U << 5)
+#define CBOR_MAP    (5U << 5)
+#define CBOR_SIMPLE (7U << 5)
+
+/**
+ * Encode the head of a CBOR data item (major type and argument).
+ *
+ * @returns Number of bytes written or -ENOMEM if the buffer is too small
+ */
+int report_cbor_encode_head(uint8_t *buf, size_t size, uint8_t major, uint32_t value);
+
+/**
+ * Write the full path of a data object by walking up its parents.
+ *
+ * @returns Length of the path (without null termination) or -ENOMEM if the buffer is too small
+ */
+int report_get_path(char *buf, size_t size, const struct thingset_data_object *obj);
+
+/**
+ * Encode the report header of the object referenced by the handle.
+ *
+ * Text mode headers contain the hash sign, the path and a trailing space. Binary mode headers
+ * contain the report function code followed by the ID or path of the object.
+ *
+ * @returns Length of the header or negative errno in case of error
+ */
+int report_encode_header(uint8_t *buf, size_t size, const struct thingset_report_handle *handle,
+                         enum thingset_data_format format);
+
+#endif /* THINGSET_REPORT_H_ */
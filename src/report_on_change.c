@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) The ThingSet Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <thingset.h>
+#include <thingset/sdk.h>
+
+#include "report.h"
+#include "report_on_change.h"
+
+LOG_MODULE_REGISTER(thingset_report_on_change, CONFIG_THINGSET_SDK_LOG_LEVEL);
+
+/* maximum length of an object path used as a key in delta reports */
+#define PATH_MAX_LEN 64
+
+struct tracked_item
+{
+    const struct thingset_data_object *obj;
+    float abs_deadband;
+    float rel_deadband;
+    /** Last reported value of numeric items */
+    double value;
+    /** CRC of the last reported value for all other items */
+    uint32_t crc;
+    bool numeric;
+    /** Item has to be included in the next delta report */
+    bool changed;
+};
+
+static struct tracked_item items[CONFIG_THINGSET_REPORTING_ON_CHANGE_MAX_ITEMS];
+static int num_items;
+
+/* items not fitting into above array are included in every report */
+static int num_untracked;
+
+static int num_changed;
+
+static struct thingset_report_handle live_report;
+
+void report_on_change_init(void)
+{
+    struct thingset_data_object *obj = NULL;
+
+    thingset_sdk_report_handle_init_by_id(&live_report, TS_ID_SUBSET_LIVE);
+
+    while ((obj = thingset_iterate_subsets(&ts, TS_SUBSET_LIVE, obj)) != NULL) {
+        if (num_items < ARRAY_SIZE(items)) {
+            items[num_items++].obj = obj;
+        }
+        else {
+            num_untracked++;
+        }
+        obj++; /* continue with object behind current one */
+    }
+
+    if (num_untracked > 0) {
+        LOG_WRN("%d items of %s exceed max. number of tracked items", num_untracked,
+                TS_NAME_SUBSET_LIVE);
+    }
+}
+
+int thingset_sdk_report_set_deadband(uint16_t id, float abs_deadband, float rel_deadband)
+{
+    for (int i = 0; i < num_items; i++) {
+        if (items[i].obj->id == id) {
+            items[i].abs_deadband = abs_deadband;
+            items[i].rel_deadband = rel_deadband;
+            return 0;
+        }
+    }
+
+    return -ENOENT;
+}
+
+/*
+ * Extract the numeric value of a CBOR-encoded item. Other types (e.g. strings, arrays or decimal
+ * fractions) are not interpreted and compared based on their encoding instead.
+ */
+static bool cbor_decode_number(const uint8_t *buf, size_t len, double *value)
+{
+    uint8_t major = buf[0] & 0xE0;
+    uint8_t info = buf[0] & 0x1F;
+
+    if (major == CBOR_UINT || major == CBOR_NEGINT) {
+        uint64_t num = 0;
+
+        if (info < 24) {
+            num = info;
+        }
+        else if (info <= 27 && len >= 1 + (1U << (info - 24))) {
+            for (int i = 0; i < (1U << (info - 24)); i++) {
+                num = (num << 8) | buf[1 + i];
+            }
+        }
+        else {
+            return false;
+        }
+
+        *value = (major == CBOR_UINT) ? (double)num : -1.0 - (double)num;
+        return true;
+    }
+    else if (major == CBOR_SIMPLE) {
+        if (info == 20 || info == 21) {
+            /* false or true */
+            *value = info - 20;
+            return true;
+        }
+        else if (info == 26 && len >= 5) {
+            uint32_t raw = sys_get_be32(&buf[1]);
+            float f32;
+            memcpy(&f32, &raw, sizeof(f32));
+            *value = f32;
+            return true;
+        }
+        else if (info == 27 && len >= 9) {
+            uint64_t raw = sys_get_be64(&buf[1]);
+            memcpy(value, &raw, sizeof(*value));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * A change is reported if it exceeds the absolute or the relative deadband, so the smaller of
+ * both thresholds applies. Deadbands set to 0 are not configured and ignored.
+ */
+static bool exceeds_deadband(const struct tracked_item *item, double value)
+{
+    if (isnan(value) || isnan(item->value)) {
+        return isnan(value) != isnan(item->value);
+    }
+
+    double abs_threshold = item->abs_deadband;
+    double rel_threshold = item->rel_deadband * fabs(item->value);
+    double threshold;
+
+    if (item->abs_deadband > 0 && item->rel_deadband > 0) {
+        threshold = MIN(abs_threshold, rel_threshold);
+    }
+    else if (item->abs_deadband > 0) {
+        threshold = abs_threshold;
+    }
+    else {
+        threshold = rel_threshold;
+    }
+
+    return fabs(value - item->value) > threshold;
+}
+
+int report_on_change_update(bool keyframe)
+{
+    /* scratch buffer for the exported values, so that no TX buffer is held for the comparison */
+    static uint8_t value_buf[CONFIG_THINGSET_REPORTING_ON_CHANGE_VALUE_BUF_SIZE];
+
+    num_changed = 0;
+
+    for (int i = 0; i < num_items; i++) {
+        struct tracked_item *item = &items[i];
+        double value = 0.0;
+        uint32_t crc = 0;
+        bool numeric;
+
+        int len = thingset_export_item(&ts, value_buf, sizeof(value_buf), item->obj,
+                                       THINGSET_BIN_VALUES_ONLY);
+        if (len <= 0) {
+            /* value can't be compared, so it is always reported */
+            item->changed = true;
+            num_changed++;
+            continue;
+        }
+
+        numeric = cbor_decode_number(value_buf, len, &value);
+        if (!numeric) {
+            crc = crc32_ieee(value_buf, len);
+        }
+
+        item->changed = keyframe || numeric != item->numeric
+                        || (numeric ? exceeds_deadband(item, value) : crc != item->crc);
+
+        if (item->changed) {
+            /* store reported value as reference for the next comparison */
+            item->numeric = numeric;
+            item->value = value;
+            item->crc = crc;
+            num_changed++;
+        }
+    }
+
+    return num_changed + num_untracked;
+}
+
+static bool is_included(int index)
+{
+    return index >= num_items || items[index].changed;
+}
+
+static int encode_txt(char *buf, size_t size)
+{
+    struct thingset_data_object *obj = NULL;
+    int index = 0;
+    int pos, len;
+
+    pos = report_encode_header((uint8_t *)buf, size, &live_report, THINGSET_TXT_NAMES_VALUES);
+    if (pos < 0 || pos + 1 >= size) {
+        return -ENOMEM;
+    }
+    buf[pos++] = '{';
+
+    while ((obj = thingset_iterate_subsets(&ts, TS_SUBSET_LIVE, obj)) != NULL) {
+        if (is_included(index)) {
+            if (pos + 1 >= size) {
+                return -ENOMEM;
+            }
+            buf[pos++] = '"';
+
+            len = report_get_path(buf + pos, size - pos, obj);
+            if (len < 0 || pos + len + 2 >= size) {
+                return -ENOMEM;
+            }
+            pos += len;
+            buf[pos++] = '"';
+            buf[pos++] = ':';
+
+            len = thingset_export_item(&ts, buf + pos, size - pos, obj,
+                                       THINGSET_TXT_NAMES_VALUES);
+            if (len <= 0 || pos + len + 1 >= size) {
+                return -ENOMEM;
+            }
+            pos += len;
+            buf[pos++] = ',';
+        }
+        index++;
+        obj++;
+    }
+
+    if (buf[pos - 1] == ',') {
+        pos--;
+    }
+
+    if (pos + 2 > size) {
+        return -ENOMEM;
+    }
+    buf[pos++] = '}';
+    buf[pos] = '\0';
+
+    return pos;
+}
+
+static int encode_bin_key(uint8_t *buf, size_t size, const struct thingset_data_object *obj,
+                          enum thingset_data_format format)
+{
+    if (format == THINGSET_BIN_IDS_VALUES) {
+        return report_cbor_encode_head(buf, size, CBOR_UINT, obj->id);
+    }
+    else {
+        char path[PATH_MAX_LEN];
+        int path_len = report_get_path(path, sizeof(path), obj);
+        if (path_len < 0) {
+            return path_len;
+        }
+
+        int len = report_cbor_encode_head(buf, size, CBOR_TEXT, path_len);
+        if (len < 0 || len + path_len > size) {
+            return -ENOMEM;
+        }
+        memcpy(buf + len, path, path_len);
+
+        return len + path_len;
+    }
+}
+
+static int encode_bin(uint8_t *buf, size_t size, enum thingset_data_format format)
+{
+    struct thingset_data_object *obj = NULL;
+    int index = 0;
+    int pos, len;
+
+    pos = report_encode_header(buf, size, &live_report, format);
+    if (pos < 0) {
+        return pos;
+    }
+
+    len = report_cbor_encode_head(buf + pos, size - pos, CBOR_MAP, num_changed + num_untracked);
+    if (len < 0) {
+        return len;
+    }
+    pos += len;
+
+    while ((obj = thingset_iterate_subsets(&ts, TS_SUBSET_LIVE, obj)) != NULL) {
+        if (is_included(index)) {
+            len = encode_bin_key(buf + pos, size - pos, obj, format);
+            if (len < 0) {
+                return len;
+            }
+            pos += len;
+
+            len = thingset_export_item(&ts, buf + pos, size - pos, obj,
+                                       THINGSET_BIN_VALUES_ONLY);
+            if (len <= 0) {
+                return -ENOMEM;
+            }
+            pos += len;
+        }
+        index++;
+        obj++;
+    }
+
+    return pos;
+}
+
+int report_on_change_encode(uint8_t *buf, size_t size, enum thingset_data_format format)
+{
+    switch (format) {
+        case THINGSET_TXT_NAMES_VALUES:
+            return encode_txt((char *)buf, size);
+        case THINGSET_BIN_IDS_VALUES:
+        case THINGSET_BIN_NAMES_VALUES:
+            return encode_bin(buf, size, format);
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) The ThingSet Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef THINGSET_REPORT_ON_CHANGE_H_
+#define THINGSET_REPORT_ON_CHANGE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <thingset.h>
+
+/**
+ * Collect all items of the live metrics subset for change tracking.
+ */
+void report_on_change_init(void);
+
+/**
+ * Compare the current values of all tracked items with the values sent last time.
+ *
+ * Items which moved beyond their deadband are marked for the next delta report and their
+ * current value is stored as the new reference value.
+ *
+ * @param keyframe True if a full report is sent, so all reference values are updated.
+ *
+ * @returns Number of items to be included in the next delta report
+ */
+int report_on_change_update(bool keyframe);
+
+/**
+ * Encode a report containing only the items marked by the last report_on_change_update() call.
+ *
+ * @param buf Buffer to store the report
+ * @param size Size of the buffer
+ * @param format Protocol data format to be used
+ *
+ * @returns Length of the report, 0 if the format is not supported for delta reports or negative
+ *          errno in case of error
+ */
+int report_on_change_encode(uint8_t *buf, size_t size, enum thingset_data_format format);
+
+#endif /* THINGSET_REPORT_ON_CHANGE_H_ */
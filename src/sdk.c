@@ -17,6 +17,10 @@
 #include <thingset.h>
 #include <thingset/sdk.h>
 
+#ifdef CONFIG_THINGSET_REPORTING_ON_CHANGE
+#include "report_on_change.h"
+#endif
+
 #ifdef CONFIG_THINGSET_PID_EUI
 #include <unistd.h>
 #endif
@@ -35,14 +39,30 @@ uint8_t eui64[8];
 
 char node_name[] = CONFIG_THINGSET_NODE_NAME;
 
-/* buffer should be word-aligned e.g. for hardware CRC calculations */
-static uint8_t buf_data[CONFIG_THINGSET_SHARED_TX_BUF_SIZE] __aligned(sizeof(int));
+/* buffers should be word-aligned e.g. for hardware CRC calculations */
+static uint8_t buf_data_large[CONFIG_THINGSET_SDK_TX_BUF_LARGE_COUNT]
+                             [CONFIG_THINGSET_SHARED_TX_BUF_SIZE] __aligned(sizeof(int));
+
+#if CONFIG_THINGSET_SDK_TX_BUF_SMALL_COUNT > 0
+static uint8_t buf_data_small[CONFIG_THINGSET_SDK_TX_BUF_SMALL_COUNT]
+                             [CONFIG_THINGSET_SDK_TX_BUF_SMALL_SIZE] __aligned(sizeof(int));
+#endif
+
+#define TX_BUF_SMALL_INIT(i, _) \
+    { .data = buf_data_small[i], .size = sizeof(buf_data_small[i]) },
+
+#define TX_BUF_LARGE_INIT(i, _) \
+    { .data = buf_data_large[i], .size = sizeof(buf_data_large[i]) },
 
-static struct shared_buffer sbuf = {
-    .data = buf_data,
-    .size = sizeof(buf_data),
+/* sorted by ascending size, so that the smallest suitable buffer is found first */
+static struct shared_buffer tx_bufs[] = {
+    LISTIFY(CONFIG_THINGSET_SDK_TX_BUF_SMALL_COUNT, TX_BUF_SMALL_INIT, ())
+    LISTIFY(CONFIG_THINGSET_SDK_TX_BUF_LARGE_COUNT, TX_BUF_LARGE_INIT, ())
 };
 
+/* first large buffer is used for the legacy thingset_sdk_shared_buffer() API */
+#define TX_BUF_LEGACY_INDEX CONFIG_THINGSET_SDK_TX_BUF_SMALL_COUNT
+
 K_THREAD_STACK_DEFINE(thread_stack_area, CONFIG_THINGSET_SDK_THREAD_STACK_SIZE);
 
 /*
@@ -52,16 +72,82 @@ K_THREAD_STACK_DEFINE(thread_stack_area, CONFIG_THINGSET_SDK_THREAD_STACK_SIZE);
  */
 static struct k_work_q thingset_workq;
 
+#ifdef CONFIG_THINGSET_SDK_BACKGROUND_WORKQ
+
+K_THREAD_STACK_DEFINE(background_stack_area, CONFIG_THINGSET_SDK_BACKGROUND_THREAD_STACK_SIZE);
+
+/* slow tasks like storage access must not delay request processing and reports */
+static struct k_work_q background_workq;
+
+#endif
+
 #ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
 bool live_reporting_enable = IS_ENABLED(CONFIG_THINGSET_REPORTING_LIVE_ENABLE_PRESET);
 uint32_t live_reporting_period = CONFIG_THINGSET_REPORTING_LIVE_PERIOD_PRESET_MS;
 #endif
 
+#ifdef CONFIG_THINGSET_REPORTING_ON_CHANGE
+bool live_reporting_on_change = IS_ENABLED(CONFIG_THINGSET_REPORTING_ON_CHANGE_PRESET);
+uint32_t live_reporting_keyframe_interval = CONFIG_THINGSET_REPORTING_KEYFRAME_INTERVAL_PRESET;
+#endif
+
 #ifdef CONFIG_THINGSET_SUBSET_SUMMARY_METRICS
 bool summary_reporting_enable = IS_ENABLED(CONFIG_THINGSET_REPORTING_SUMMARY_ENABLE_PRESET);
 uint32_t summary_reporting_period = CONFIG_THINGSET_REPORTING_SUMMARY_PERIOD_PRESET;
 #endif
 
+#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
+static sys_slist_t live_report_sinks = SYS_SLIST_STATIC_INIT(&live_report_sinks);
+static K_MUTEX_DEFINE(live_report_sinks_lock);
+static struct thingset_report_job live_reporting_job;
+static struct thingset_report_handle live_report;
+#endif
+
+#ifdef CONFIG_THINGSET_REPORT_CACHE
+struct report_cache_entry
+{
+    uint16_t subset;
+    enum thingset_data_format format;
+    bool valid;
+    size_t len;
+    uint8_t data[CONFIG_THINGSET_REPORT_CACHE_SIZE];
+};
+
+static struct report_cache_entry report_cache[CONFIG_THINGSET_REPORT_CACHE_ENTRIES];
+static K_MUTEX_DEFINE(report_cache_lock);
+
+/* incremented with each invalidation to detect data changes during encoding */
+static uint32_t report_cache_generation;
+static int report_cache_next_entry;
+
+static uint32_t report_cache_hits;
+static uint32_t report_cache_misses;
+#endif
+
+/* statistics of all periodic report jobs, updated from the SDK and background work queues */
+static atomic_t report_sched_missed;
+static atomic_t report_sched_max_jitter;
+
+/* copy of the statistics exposed via ThingSet, updated before each read */
+static uint32_t report_sched_missed_snapshot;
+static uint32_t report_sched_max_jitter_snapshot;
+
+/* decisions taken if the TX buffer pool was exhausted */
+enum tx_buf_counter
+{
+    TX_BUF_SKIPPED,
+    TX_BUF_COALESCED,
+    TX_BUF_WAITED,
+    TX_BUF_TIMEOUTS,
+    TX_BUF_NUM_COUNTERS,
+};
+
+/* incremented by all interfaces, so they have to be updated atomically */
+static atomic_t tx_buf_counters[TX_BUF_NUM_COUNTERS];
+
+/* copy of the counters exposed via ThingSet, updated before each read */
+static uint32_t tx_buf_snapshot[TX_BUF_NUM_COUNTERS];
+
 struct thingset_context ts;
 
 THINGSET_ADD_ITEM_STRING(TS_ID_ROOT, THINGSET_ID_NODEID, "pNodeID", node_id, sizeof(node_id),
@@ -71,7 +157,8 @@ THINGSET_ADD_ITEM_STRING(TS_ID_ROOT, TS_ID_NODENAME, "pNodeName", node_name, siz
                          THINGSET_ANY_R | THINGSET_MFR_W, TS_SUBSET_NVM);
 
 #if defined(CONFIG_THINGSET_WIFI) || defined(CONFIG_THINGSET_WEBSOCKET) \
-    || (defined(CONFIG_THINGSET_CAN) && !defined(CONFIG_THINGSET_CAN_MULTIPLE_INSTANCES))
+    || (defined(CONFIG_THINGSET_CAN) && !defined(CONFIG_THINGSET_CAN_MULTIPLE_INSTANCES)) \
+    || defined(CONFIG_THINGSET_SERIAL_BAUD_NEGOTIATION) || defined(CONFIG_THINGSET_BLUETOOTH)
 THINGSET_ADD_GROUP(TS_ID_ROOT, TS_ID_NET, "Networking", THINGSET_NO_CALLBACK);
 #endif
 
@@ -85,7 +172,38 @@ THINGSET_ADD_SUBSET(TS_ID_ROOT, TS_ID_SUBSET_SUMMARY, TS_NAME_SUBSET_SUMMARY, TS
                     THINGSET_ANY_RW);
 #endif
 
-THINGSET_ADD_GROUP(TS_ID_ROOT, TS_ID_REPORTING, "_Reporting", THINGSET_NO_CALLBACK);
+static void reporting_read_cb(enum thingset_callback_reason reason)
+{
+    if (reason == THINGSET_CALLBACK_PRE_READ) {
+        for (int i = 0; i < TX_BUF_NUM_COUNTERS; i++) {
+            tx_buf_snapshot[i] = atomic_get(&tx_buf_counters[i]);
+        }
+        report_sched_missed_snapshot = atomic_get(&report_sched_missed);
+        report_sched_max_jitter_snapshot = atomic_get(&report_sched_max_jitter);
+    }
+}
+
+THINGSET_ADD_GROUP(TS_ID_ROOT, TS_ID_REPORTING, "_Reporting", reporting_read_cb);
+
+#ifdef CONFIG_THINGSET_REPORT_CACHE
+THINGSET_ADD_ITEM_UINT32(TS_ID_REPORTING, TS_ID_REP_CACHE_HITS, "rCacheHits", &report_cache_hits,
+                         THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(TS_ID_REPORTING, TS_ID_REP_CACHE_MISSES, "rCacheMisses",
+                         &report_cache_misses, THINGSET_ANY_R, 0);
+#endif
+
+THINGSET_ADD_ITEM_UINT32(TS_ID_REPORTING, TS_ID_REP_SCHED_MISSED, "rMissedPeriods",
+                         &report_sched_missed_snapshot, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(TS_ID_REPORTING, TS_ID_REP_SCHED_JITTER, "rMaxJitter_ms",
+                         &report_sched_max_jitter_snapshot, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(TS_ID_REPORTING, TS_ID_REP_BUF_SKIPPED, "rBufSkipped",
+                         &tx_buf_snapshot[TX_BUF_SKIPPED], THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(TS_ID_REPORTING, TS_ID_REP_BUF_COALESCED, "rBufCoalesced",
+                         &tx_buf_snapshot[TX_BUF_COALESCED], THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(TS_ID_REPORTING, TS_ID_REP_BUF_WAITED, "rBufWaited",
+                         &tx_buf_snapshot[TX_BUF_WAITED], THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(TS_ID_REPORTING, TS_ID_REP_BUF_TIMEOUTS, "rBufTimeouts",
+                         &tx_buf_snapshot[TX_BUF_TIMEOUTS], THINGSET_ANY_R, 0);
 
 #ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
 THINGSET_ADD_GROUP(TS_ID_REPORTING, TS_ID_REP_LIVE, TS_NAME_SUBSET_LIVE, NULL);
@@ -96,6 +214,13 @@ THINGSET_ADD_ITEM_UINT32(TS_ID_REP_LIVE, TS_ID_REP_LIVE_PERIOD, "sPeriod_ms",
                          &live_reporting_period, THINGSET_ANY_RW, TS_SUBSET_NVM);
 #endif
 
+#ifdef CONFIG_THINGSET_REPORTING_ON_CHANGE
+THINGSET_ADD_ITEM_BOOL(TS_ID_REP_LIVE, TS_ID_REP_LIVE_ON_CHANGE, "sOnChange",
+                       &live_reporting_on_change, THINGSET_ANY_RW, TS_SUBSET_NVM);
+THINGSET_ADD_ITEM_UINT32(TS_ID_REP_LIVE, TS_ID_REP_LIVE_KEYFRAME_INTERVAL, "sKeyframeInterval",
+                         &live_reporting_keyframe_interval, THINGSET_ANY_RW, TS_SUBSET_NVM);
+#endif
+
 #ifdef CONFIG_THINGSET_SUBSET_SUMMARY_METRICS
 THINGSET_ADD_GROUP(TS_ID_REPORTING, TS_ID_REP_SUMMARY, TS_NAME_SUBSET_SUMMARY, NULL);
 THINGSET_ADD_ITEM_BOOL(TS_ID_REP_SUMMARY, TS_ID_REP_SUMMARY_ENABLE, "sEnable",
@@ -156,7 +281,339 @@ static void generate_device_eui()
 
 struct shared_buffer *thingset_sdk_shared_buffer(void)
 {
-    return &sbuf;
+    return &tx_bufs[TX_BUF_LEGACY_INDEX];
+}
+
+struct shared_buffer *thingset_sdk_tx_buf_acquire(size_t min_size, k_timeout_t timeout)
+{
+    struct k_poll_event events[ARRAY_SIZE(tx_bufs)];
+    k_timepoint_t end = sys_timepoint_calc(timeout);
+    int num_events;
+
+    do {
+        num_events = 0;
+        for (int i = 0; i < ARRAY_SIZE(tx_bufs); i++) {
+            if (tx_bufs[i].size < min_size) {
+                continue;
+            }
+
+            if (k_sem_take(&tx_bufs[i].lock, K_NO_WAIT) == 0) {
+                tx_bufs[i].pos = 0;
+                return &tx_bufs[i];
+            }
+
+            k_poll_event_init(&events[num_events++], K_POLL_TYPE_SEM_AVAILABLE,
+                              K_POLL_MODE_NOTIFY_ONLY, &tx_bufs[i].lock);
+        }
+
+        if (num_events == 0) {
+            LOG_ERR("No TX buffer with %zu bytes available", min_size);
+            return NULL;
+        }
+
+        /* wait until any of the suitable buffers is released and try again */
+    } while (k_poll(events, num_events, sys_timepoint_timeout(end)) == 0);
+
+    return NULL;
+}
+
+struct shared_buffer *thingset_sdk_tx_buf_acquire_policy(size_t min_size,
+                                                         enum thingset_sdk_tx_buf_policy policy,
+                                                         k_timeout_t timeout)
+{
+    struct shared_buffer *buf = thingset_sdk_tx_buf_acquire(min_size, K_NO_WAIT);
+    if (buf != NULL) {
+        return buf;
+    }
+
+    switch (policy) {
+        case THINGSET_SDK_TX_BUF_SKIP:
+            atomic_inc(&tx_buf_counters[TX_BUF_SKIPPED]);
+            break;
+        case THINGSET_SDK_TX_BUF_COALESCE:
+            atomic_inc(&tx_buf_counters[TX_BUF_COALESCED]);
+            break;
+        case THINGSET_SDK_TX_BUF_WAIT:
+            atomic_inc(&tx_buf_counters[TX_BUF_WAITED]);
+            buf = thingset_sdk_tx_buf_acquire(min_size, timeout);
+            if (buf == NULL) {
+                atomic_inc(&tx_buf_counters[TX_BUF_TIMEOUTS]);
+            }
+            break;
+    }
+
+    return buf;
+}
+
+void thingset_sdk_tx_buf_release(struct shared_buffer *buf)
+{
+    buf->pos = 0;
+    k_sem_give(&buf->lock);
+}
+
+static bool is_write_request(const uint8_t *msg, size_t msg_len)
+{
+    if (msg_len == 0) {
+        return false;
+    }
+
+    switch (msg[0]) {
+        case '=': /* text mode update */
+        case '+': /* text mode create */
+        case '-': /* text mode delete */
+        case '!': /* text mode exec */
+        case 0x02: /* binary mode exec */
+        case 0x04: /* binary mode delete */
+        case 0x06: /* binary mode create */
+        case 0x07: /* binary mode update */
+            return true;
+        default:
+            return false;
+    }
+}
+
+int thingset_sdk_process_message(const uint8_t *msg, size_t msg_len, uint8_t *rsp,
+                                 size_t rsp_size)
+{
+    int len = thingset_process_message(&ts, msg, msg_len, rsp, rsp_size);
+
+    if (is_write_request(msg, msg_len)) {
+        /* the request may have changed any object, so all cached reports are outdated */
+        thingset_sdk_report_mark_dirty(UINT16_MAX);
+    }
+
+    return len;
+}
+
+void thingset_sdk_report_mark_dirty(uint16_t subsets)
+{
+#ifdef CONFIG_THINGSET_REPORT_CACHE
+    k_mutex_lock(&report_cache_lock, K_FOREVER);
+
+    report_cache_generation++;
+    for (int i = 0; i < ARRAY_SIZE(report_cache); i++) {
+        if (report_cache[i].subset & subsets) {
+            report_cache[i].valid = false;
+        }
+    }
+
+    k_mutex_unlock(&report_cache_lock);
+#endif
+}
+
+#ifdef CONFIG_THINGSET_REPORT_CACHE
+
+static struct report_cache_entry *report_cache_find(uint16_t subset,
+                                                    enum thingset_data_format format)
+{
+    for (int i = 0; i < ARRAY_SIZE(report_cache); i++) {
+        if (report_cache[i].subset == subset && report_cache[i].format == format) {
+            return &report_cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+int thingset_sdk_report_subset(const struct thingset_report_handle *handle, uint8_t *buf,
+                               size_t size, enum thingset_data_format format)
+{
+    struct report_cache_entry *entry;
+    uint32_t generation;
+    uint16_t subset;
+    int len;
+
+    if (handle->obj == NULL || handle->obj->type != THINGSET_TYPE_SUBSET) {
+        return thingset_sdk_report_by_handle(handle, buf, size, format);
+    }
+
+    subset = handle->obj->data.subset;
+
+    k_mutex_lock(&report_cache_lock, K_FOREVER);
+
+    entry = report_cache_find(subset, format);
+    if (entry != NULL && entry->valid && entry->len <= size) {
+        memcpy(buf, entry->data, entry->len);
+        len = entry->len;
+        report_cache_hits++;
+        k_mutex_unlock(&report_cache_lock);
+        return len;
+    }
+
+    report_cache_misses++;
+    generation = report_cache_generation;
+
+    k_mutex_unlock(&report_cache_lock);
+
+    /* encode without holding the lock to avoid blocking thingset_sdk_report_mark_dirty() */
+    len = thingset_sdk_report_by_handle(handle, buf, size, format);
+    if (len <= 0 || len > CONFIG_THINGSET_REPORT_CACHE_SIZE) {
+        return len;
+    }
+
+    k_mutex_lock(&report_cache_lock, K_FOREVER);
+
+    /* only store the report if the data was not changed in the meantime */
+    if (generation == report_cache_generation) {
+        entry = report_cache_find(subset, format);
+        if (entry == NULL) {
+            entry = &report_cache[report_cache_next_entry];
+            report_cache_next_entry = (report_cache_next_entry + 1) % ARRAY_SIZE(report_cache);
+        }
+
+        memcpy(entry->data, buf, len);
+        entry->len = len;
+        entry->subset = subset;
+        entry->format = format;
+        entry->valid = true;
+    }
+
+    k_mutex_unlock(&report_cache_lock);
+
+    return len;
+}
+
+#else
+
+int thingset_sdk_report_subset(const struct thingset_report_handle *handle, uint8_t *buf,
+                               size_t size, enum thingset_data_format format)
+{
+    return thingset_sdk_report_by_handle(handle, buf, size, format);
+}
+
+#endif /* CONFIG_THINGSET_REPORT_CACHE */
+
+#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
+
+void thingset_sdk_register_report_sink(struct thingset_report_sink *sink)
+{
+    k_mutex_lock(&live_report_sinks_lock, K_FOREVER);
+    sys_slist_append(&live_report_sinks, &sink->node);
+    k_mutex_unlock(&live_report_sinks_lock);
+}
+
+/*
+ * A live report was dropped due to backpressure or a sink failed to send it, so it has to be
+ * merged into the next one (i.e. the next on-change report is a keyframe).
+ */
+static bool live_report_coalesce;
+
+#ifdef CONFIG_THINGSET_REPORTING_ON_CHANGE
+
+static uint32_t periods_since_keyframe = UINT32_MAX;
+
+static bool live_report_keyframe_due(void)
+{
+    if (periods_since_keyframe == UINT32_MAX
+        || (live_reporting_keyframe_interval > 0
+            && periods_since_keyframe + 1 >= live_reporting_keyframe_interval))
+    {
+        periods_since_keyframe = 0;
+        return true;
+    }
+
+    periods_since_keyframe++;
+    return false;
+}
+
+#endif /* CONFIG_THINGSET_REPORTING_ON_CHANGE */
+
+static void live_report_dispatch(enum thingset_data_format format, bool delta)
+{
+    struct thingset_report_sink *sink;
+    int len = 0;
+
+    /* never block the work queue, the latest values are sent with the next report anyway */
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire_policy(
+        CONFIG_THINGSET_SHARED_TX_BUF_SIZE, THINGSET_SDK_TX_BUF_COALESCE, K_NO_WAIT);
+    if (tx_buf == NULL) {
+        live_report_coalesce = true;
+        return;
+    }
+
+#ifdef CONFIG_THINGSET_REPORTING_ON_CHANGE
+    if (delta) {
+        /* falls back to full report for formats not supported by delta reports */
+        len = report_on_change_encode(tx_buf->data, tx_buf->size, format);
+    }
+#endif
+
+    if (len == 0) {
+        len = thingset_sdk_report_subset(&live_report, tx_buf->data, tx_buf->size, format);
+    }
+
+    if (len > 0) {
+        SYS_SLIST_FOR_EACH_CONTAINER(&live_report_sinks, sink, node)
+        {
+            if (sink->format == format && sink->send(sink, tx_buf->data, len) < 0) {
+                live_report_coalesce = true;
+            }
+        }
+    }
+    else {
+        LOG_ERR("Failed to encode live report: %d", len);
+        /* the changes were not sent, so they are covered by the next report */
+        live_report_coalesce = true;
+    }
+
+    thingset_sdk_tx_buf_release(tx_buf);
+}
+
+static void live_reporting_handler(struct thingset_report_job *job)
+{
+    struct thingset_report_sink *sink;
+    uint32_t formats_sent = 0;
+    bool delta = false;
+
+    if (live_reporting_enable) {
+#ifdef CONFIG_THINGSET_REPORTING_ON_CHANGE
+        if (live_reporting_on_change) {
+            if (live_report_coalesce) {
+                /* changes of dropped delta reports are only covered by a keyframe */
+                periods_since_keyframe = UINT32_MAX;
+            }
+            delta = !live_report_keyframe_due();
+            int num_changed = report_on_change_update(!delta);
+            if (num_changed == 0) {
+                /* nothing changed beyond the deadbands */
+                return;
+            }
+        }
+        else {
+            /* start with a keyframe as soon as on-change reporting is enabled again */
+            periods_since_keyframe = UINT32_MAX;
+        }
+#endif
+
+        live_report_coalesce = false;
+
+        k_mutex_lock(&live_report_sinks_lock, K_FOREVER);
+
+        /* encode the report only once for all sinks expecting the same format */
+        SYS_SLIST_FOR_EACH_CONTAINER(&live_report_sinks, sink, node)
+        {
+            if ((formats_sent & BIT(sink->format)) == 0) {
+                live_report_dispatch(sink->format, delta);
+                formats_sent |= BIT(sink->format);
+            }
+        }
+
+        k_mutex_unlock(&live_report_sinks_lock);
+    }
+}
+
+#endif /* CONFIG_THINGSET_SUBSET_LIVE_METRICS */
+
+static void report_sched_jitter_update(uint32_t jitter)
+{
+    atomic_val_t max;
+
+    do {
+        max = atomic_get(&report_sched_max_jitter);
+        if ((uint32_t)max >= jitter) {
+            return;
+        }
+    } while (!atomic_cas(&report_sched_max_jitter, max, (atomic_val_t)jitter));
 }
 
 int thingset_sdk_reschedule_work(struct k_work_delayable *dwork, k_timeout_t delay)
@@ -164,9 +621,69 @@ int thingset_sdk_reschedule_work(struct k_work_delayable *dwork, k_timeout_t del
     return k_work_reschedule_for_queue(&thingset_workq, dwork, delay);
 }
 
+static void report_job_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct thingset_report_job *job = CONTAINER_OF(dwork, struct thingset_report_job, work);
+    int64_t period = MAX((int64_t)*job->period * job->period_unit_ms, 1);
+    int64_t now = k_uptime_get();
+
+    if (now > job->deadline) {
+        uint32_t jitter = MIN(now - job->deadline, UINT32_MAX);
+        job->max_jitter = MAX(job->max_jitter, jitter);
+        report_sched_jitter_update(jitter);
+    }
+
+    job->fn(job);
+
+    job->deadline += period;
+
+    now = k_uptime_get();
+    if (now - job->deadline >= period) {
+        /* skip periods missed due to high load instead of catching up in a burst */
+        uint32_t missed = (now - job->deadline) / period;
+        job->deadline += missed * period;
+        job->missed += missed;
+        atomic_add(&report_sched_missed, missed);
+    }
+
+    thingset_sdk_reschedule_work_prio(dwork, K_TIMEOUT_ABS_MS(job->deadline), job->prio);
+}
+
+void thingset_sdk_report_job_start(struct thingset_report_job *job)
+{
+    static atomic_t num_jobs;
+    int64_t period = MAX((int64_t)*job->period * job->period_unit_ms, 1);
+
+    /* spread the jobs over the period to avoid bursts of CPU and bus load */
+    int64_t phase = ((int64_t)atomic_inc(&num_jobs) * CONFIG_THINGSET_REPORT_SCHED_STAGGER_MS)
+                    % period;
+
+    job->deadline = k_uptime_get() + phase;
+    job->missed = 0;
+    job->max_jitter = 0;
+
+    k_work_init_delayable(&job->work, report_job_handler);
+    thingset_sdk_reschedule_work_prio(&job->work, K_TIMEOUT_ABS_MS(job->deadline), job->prio);
+}
+
+int thingset_sdk_reschedule_work_prio(struct k_work_delayable *dwork, k_timeout_t delay,
+                                      enum thingset_sdk_work_prio prio)
+{
+#ifdef CONFIG_THINGSET_SDK_BACKGROUND_WORKQ
+    if (prio == THINGSET_SDK_PRIO_BACKGROUND) {
+        return k_work_reschedule_for_queue(&background_workq, dwork, delay);
+    }
+#endif
+
+    return k_work_reschedule_for_queue(&thingset_workq, dwork, delay);
+}
+
 static int thingset_sdk_init(void)
 {
-    k_sem_init(&sbuf.lock, 1, 1);
+    for (int i = 0; i < ARRAY_SIZE(tx_bufs); i++) {
+        k_sem_init(&tx_bufs[i].lock, 1, 1);
+    }
 
     k_work_queue_init(&thingset_workq);
     k_work_queue_start(&thingset_workq, thread_stack_area, K_THREAD_STACK_SIZEOF(thread_stack_area),
@@ -174,8 +691,31 @@ static int thingset_sdk_init(void)
 
     k_thread_name_set(&thingset_workq.thread, "thingset_sdk");
 
+#ifdef CONFIG_THINGSET_SDK_BACKGROUND_WORKQ
+    k_work_queue_init(&background_workq);
+    k_work_queue_start(&background_workq, background_stack_area,
+                       K_THREAD_STACK_SIZEOF(background_stack_area),
+                       CONFIG_THINGSET_SDK_BACKGROUND_THREAD_PRIORITY, NULL);
+
+    k_thread_name_set(&background_workq.thread, "thingset_sdk_bg");
+#endif
+
+    /* data objects have to be initialized before report handles are resolved */
     thingset_init_global(&ts);
 
+#ifdef CONFIG_THINGSET_REPORTING_ON_CHANGE
+    report_on_change_init();
+#endif
+
+#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
+    thingset_sdk_report_handle_init_by_id(&live_report, TS_ID_SUBSET_LIVE);
+    live_reporting_job.fn = live_reporting_handler;
+    live_reporting_job.period = &live_reporting_period;
+    live_reporting_job.period_unit_ms = 1;
+    live_reporting_job.prio = THINGSET_SDK_PRIO_HIGH;
+    thingset_sdk_report_job_start(&live_reporting_job);
+#endif
+
 #ifdef CONFIG_THINGSET_GENERATE_NODE_ID
     generate_device_eui();
 #endif
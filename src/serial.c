@@ -7,6 +7,7 @@
 #include <zephyr/drivers/uart.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/crc.h>
 
 #include <thingset.h>
@@ -14,9 +15,12 @@
 #include <thingset/serial.h>
 
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 
+#include "packetizer.h"
+#include "report.h"
+#include "stats.h"
+
 LOG_MODULE_REGISTER(thingset_serial, CONFIG_THINGSET_SDK_LOG_LEVEL);
 
 #if DT_NODE_EXISTS(DT_CHOSEN(thingset_serial))
@@ -27,170 +31,1268 @@ LOG_MODULE_REGISTER(thingset_serial, CONFIG_THINGSET_SDK_LOG_LEVEL);
 
 static const struct device *uart_dev = DEVICE_DT_GET(UART_DEVICE_NODE);
 
-static char rx_buf[CONFIG_THINGSET_SERIAL_RX_BUF_SIZE];
+struct serial_rx_buf
+{
+    char data[CONFIG_THINGSET_SERIAL_RX_BUF_SIZE];
+    size_t len;
+    /** Time when the request was received completely */
+    uint32_t timestamp;
+    /** Request was received in a binary frame */
+    bool binary;
+    /** CRC-32 of the first crc_len bytes, calculated during reception */
+    uint32_t crc;
+    size_t crc_len;
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+    /** Logical channel the request was received on */
+    uint8_t channel;
+#endif
+};
+
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+/* the local node and the gateway channel receive requests, the log channel is TX only */
+#define RX_NUM_CHANNELS 2
+
+/* number of requests per channel waiting for processing */
+static atomic_t rx_pending[RX_NUM_CHANNELS];
+#else
+#define RX_NUM_CHANNELS 1
+#endif
+
+#define RX_BUF_COUNT (CONFIG_THINGSET_SERIAL_RX_BUF_COUNT * RX_NUM_CHANNELS)
 
-static volatile size_t rx_buf_pos = 0;
+static struct serial_rx_buf rx_bufs[RX_BUF_COUNT];
+
+/* buffers are passed between ISR and work queue as pointers via the message queues */
+K_MSGQ_DEFINE(rx_free_queue, sizeof(struct serial_rx_buf *), RX_BUF_COUNT, sizeof(void *));
+K_MSGQ_DEFINE(rx_ready_queue, sizeof(struct serial_rx_buf *), RX_BUF_COUNT, sizeof(void *));
+
+/* buffer currently being filled, only accessed by the RX ISR, UART callback or polling thread */
+static struct serial_rx_buf *rx_buf;
 static bool discard_buffer;
+/* bytes of the current message were discarded (as opposed to an empty line or frame start) */
+static bool discarded_data;
+
+#ifdef CONFIG_THINGSET_SERIAL_BINARY
+/* escape sequence started in a binary frame */
+static bool rx_escape;
+#endif
 
-/* binary semaphore used as mutex in ISR context */
-static struct k_sem rx_buf_lock;
+/*
+ * Received bytes are added to the CRC as soon as they can't be part of the CRC trailer anymore,
+ * i.e. " XXXXXXXX#" plus an optional \r in text mode and the 4-byte CRC in binary mode.
+ */
+#define RX_TEXT_CRC_LAG 11
+#define RX_BIN_CRC_LAG  4
+
+/* reports are sent in the same format as the last request received from the host */
+static enum thingset_data_format report_format = THINGSET_TXT_NAMES_VALUES;
 
 static thingset_sdk_rx_callback_t rx_callback;
 
 static struct k_work_delayable processing_work;
-#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-static struct k_work_delayable reporting_work;
+
+/* length of the CRC (if enabled) and the line end appended to text messages */
+#define TX_TEXT_TRAILER_LEN ((IS_ENABLED(CONFIG_THINGSET_SERIAL_USE_CRC) ? 10 : 0) + 2)
+
+/* length of the CRC and (in multi-channel mode) the channel ID added to binary messages */
+#define TX_BIN_TRAILER_LEN (4 + (IS_ENABLED(CONFIG_THINGSET_SERIAL_CHANNELS) ? 1 : 0))
+
+/*
+ * Binary frames are escaped on the fly from the segments returned by the packetizer, so they
+ * don't need a second buffer. Only DMA-based async TX needs the entire frame in advance.
+ */
+#if defined(CONFIG_THINGSET_SERIAL_BINARY) && !defined(CONFIG_THINGSET_SERIAL_TX_ASYNC)
+#define TX_FRAME_NUM_SEGMENTS 8
 #endif
 
-int thingset_serial_send(const uint8_t *buf, size_t len)
+/* space to be reserved behind each message for the CRC and line end */
+#define TX_TRAILER_LEN                                                                            \
+    MAX(TX_TEXT_TRAILER_LEN, IS_ENABLED(CONFIG_THINGSET_SERIAL_BINARY) ? TX_BIN_TRAILER_LEN : 0)
+
+/*
+ * Text mode messages always start with a printable character, whereas binary messages start with
+ * a function code (< 0x20) or a status code (>= 0x80).
+ */
+static inline bool is_binary(uint8_t first_byte)
 {
-    if (!device_is_ready(uart_dev)) {
-        return -ENODEV;
+    return first_byte < 0x20 || first_byte >= 0x80;
+}
+
+#ifdef CONFIG_THINGSET_SERIAL_BINARY
+/* function codes of ThingSet requests and reports in binary mode */
+#define BIN_GET    0x01
+#define BIN_EXEC   0x02
+#define BIN_DELETE 0x04
+#define BIN_FETCH  0x05
+#define BIN_CREATE 0x06
+#define BIN_UPDATE 0x07
+#define BIN_DESIRE 0x1D
+#define BIN_REPORT 0x1F
+
+/*
+ * Received binary frames start with a function code or, in multi-channel mode, a channel ID. Any
+ * other byte (e.g. TAB, ESC or a UTF-8 character typed by a human) starts a text mode line.
+ */
+static inline bool is_binary_rx_start(uint8_t first_byte)
+{
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+    return first_byte < RX_NUM_CHANNELS;
+#else
+    switch (first_byte) {
+        case BIN_GET:
+        case BIN_EXEC:
+        case BIN_DELETE:
+        case BIN_FETCH:
+        case BIN_CREATE:
+        case BIN_UPDATE:
+        case BIN_DESIRE:
+        case BIN_REPORT:
+            return true;
+        default:
+            return false;
+    }
+#endif
+}
+#endif /* CONFIG_THINGSET_SERIAL_BINARY */
+
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+/* write the text mode CRC trailer " XXXXXXXX#" without using snprintf, so it's safe in an ISR */
+static void serial_put_crc_trailer(uint8_t *buf, uint32_t crc)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    buf[0] = ' ';
+    for (int i = 0; i < 8; i++) {
+        buf[1 + i] = hex[(crc >> (28 - 4 * i)) & 0xF];
+    }
+    buf[9] = '#';
+}
+#endif
+
+/*
+ * The following functions start the transmission of the raw data stored in a pool buffer and
+ * release the buffer afterwards. If crc_len is not 0, the text mode CRC is calculated on the fly
+ * over the first crc_len bytes and the trailer is written behind them just before it is sent.
+ */
+
+/*
+ * Held while a message is handed over for transmission (in polling mode until it was sent) and by
+ * streamed reports across all of their chunks, so that messages of different senders don't mix.
+ * The mutex can be locked recursively by the same thread.
+ */
+K_MUTEX_DEFINE(tx_mutex);
+
+static int serial_tx_lock(struct shared_buffer *tx_buf)
+{
+    if (k_mutex_lock(&tx_mutex, K_MSEC(CONFIG_THINGSET_SERIAL_TX_TIMEOUT_MS)) != 0) {
+        LOG_WRN("Discarded message because UART TX is busy");
+        stats_inc(STATS_SERIAL, STATS_TIMEOUTS);
+        thingset_sdk_tx_buf_release(tx_buf);
+        return -EBUSY;
+    }
+
+    return 0;
+}
+
+#ifdef CONFIG_THINGSET_SERIAL_TX_POLLING
+
+static int serial_tx_start(struct shared_buffer *tx_buf, size_t len, size_t crc_len)
+{
+    if (serial_tx_lock(tx_buf) != 0) {
+        return -EBUSY;
     }
 
     for (int i = 0; i < len; i++) {
-        uart_poll_out(uart_dev, buf[i]);
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+        if (i == crc_len && crc_len > 0) {
+            serial_put_crc_trailer(&tx_buf->data[i], crc32_ieee(tx_buf->data, crc_len));
+        }
+#endif
+        uart_poll_out(uart_dev, tx_buf->data[i]);
+    }
+
+    k_mutex_unlock(&tx_mutex);
+
+    stats_add(STATS_SERIAL, STATS_BYTES_OUT, len);
+
+    thingset_sdk_tx_buf_release(tx_buf);
+    return 0;
+}
+
+#ifdef TX_FRAME_NUM_SEGMENTS
+static int serial_tx_start_frame(struct shared_buffer *tx_buf, size_t len)
+{
+    struct packet_segment segs[TX_FRAME_NUM_SEGMENTS];
+    int pos = 0;
+    int num;
+
+    if (serial_tx_lock(tx_buf) != 0) {
+        return -EBUSY;
+    }
+
+    do {
+        num = packetize_segments(tx_buf->data, len, segs, ARRAY_SIZE(segs), SIZE_MAX, &pos);
+        for (int i = 0; i < num; i++) {
+            for (int j = 0; j < segs[i].len; j++) {
+                uart_poll_out(uart_dev, segs[i].data[j]);
+            }
+            stats_add(STATS_SERIAL, STATS_BYTES_OUT, segs[i].len);
+        }
+    } while (num > 0);
+
+    k_mutex_unlock(&tx_mutex);
+
+    thingset_sdk_tx_buf_release(tx_buf);
+    return 0;
+}
+#endif
+
+static inline bool serial_tx_idle(void)
+{
+    return true;
+}
+
+static inline int serial_tx_wait_idle(k_timeout_t timeout)
+{
+    return 0;
+}
+
+#else /* interrupt-driven or asynchronous TX */
+
+/* message queued for transmission, the buffer is released after it was sent */
+struct serial_tx_msg
+{
+    struct shared_buffer *buf;
+    size_t len;
+    size_t crc_len;
+#ifdef TX_FRAME_NUM_SEGMENTS
+    /** Binary message to be escaped and framed during transmission */
+    bool frame;
+#endif
+};
+
+/*
+ * Messages are transmitted in the order they were queued, so that the responses to pipelined
+ * requests can be sent while the next request is already processed.
+ */
+K_MSGQ_DEFINE(tx_queue, sizeof(struct serial_tx_msg), CONFIG_THINGSET_SERIAL_TX_QUEUE_LEN,
+              sizeof(void *));
+
+/* protects the message in flight, which is accessed from thread and ISR context */
+static struct k_spinlock tx_lock;
+
+/* given when the last queued message was sent */
+static K_SEM_DEFINE(tx_idle_sem, 0, 1);
+
+/* message currently being transmitted, released by the UART driver callback */
+static struct shared_buffer *tx_buf_in_flight;
+static size_t tx_len;
+static size_t tx_pos;
+
+#if defined(CONFIG_THINGSET_SERIAL_TX_INTERRUPT) && defined(CONFIG_THINGSET_SERIAL_USE_CRC)
+static size_t tx_crc_len;
+static uint32_t tx_crc;
+#endif
+
+#ifdef TX_FRAME_NUM_SEGMENTS
+/* segments of the binary frame in flight, fetched from the packetizer while the FIFO drains */
+static bool tx_frame;
+static struct packet_segment tx_segs[TX_FRAME_NUM_SEGMENTS];
+static int tx_num_segs;
+static int tx_seg_index;
+static int tx_src_pos;
+#endif
+
+/* start the transmission of the next queued message if the UART is idle (tx_lock held) */
+static void serial_tx_next(void)
+{
+    struct serial_tx_msg msg;
+
+    while (tx_buf_in_flight == NULL && k_msgq_get(&tx_queue, &msg, K_NO_WAIT) == 0) {
+        tx_buf_in_flight = msg.buf;
+        tx_len = msg.len;
+        tx_pos = 0;
+
+#ifdef CONFIG_THINGSET_SERIAL_TX_ASYNC
+        if (uart_tx(uart_dev, msg.buf->data, msg.len, SYS_FOREVER_US) != 0) {
+            /* discard the message and continue with the next one */
+            stats_inc(STATS_SERIAL, STATS_TIMEOUTS);
+            thingset_sdk_tx_buf_release(msg.buf);
+            tx_buf_in_flight = NULL;
+        }
+#else
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+        tx_crc_len = msg.crc_len;
+        tx_crc = 0;
+#endif
+#ifdef TX_FRAME_NUM_SEGMENTS
+        tx_frame = msg.frame;
+        tx_num_segs = 0;
+        tx_seg_index = 0;
+        tx_src_pos = 0;
+#endif
+        uart_irq_tx_enable(uart_dev);
+#endif
+    }
+}
+
+static void serial_tx_done(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+    thingset_sdk_tx_buf_release(tx_buf_in_flight);
+    tx_buf_in_flight = NULL;
+    serial_tx_next();
+    if (tx_buf_in_flight == NULL) {
+        k_sem_give(&tx_idle_sem);
+    }
+
+    k_spin_unlock(&tx_lock, key);
+}
+
+#ifdef CONFIG_THINGSET_SERIAL_TX_INTERRUPT
+
+#ifdef TX_FRAME_NUM_SEGMENTS
+/* refill the UART FIFO directly from the packetizer segments of the binary frame in flight */
+static void serial_tx_frame_isr(void)
+{
+    while (true) {
+        if (tx_seg_index == tx_num_segs) {
+            tx_seg_index = 0;
+            tx_num_segs = packetize_segments(tx_buf_in_flight->data, tx_len, tx_segs,
+                                             ARRAY_SIZE(tx_segs), SIZE_MAX, &tx_src_pos);
+            if (tx_num_segs == 0) {
+                uart_irq_tx_disable(uart_dev);
+                serial_tx_done();
+                return;
+            }
+            for (int i = 0; i < tx_num_segs; i++) {
+                stats_add(STATS_SERIAL, STATS_BYTES_OUT, tx_segs[i].len);
+            }
+        }
+
+        struct packet_segment *seg = &tx_segs[tx_seg_index];
+        int filled = uart_fifo_fill(uart_dev, seg->data, seg->len);
+        seg->data += filled;
+        seg->len -= filled;
+        if (seg->len > 0) {
+            /* FIFO full */
+            return;
+        }
+        tx_seg_index++;
+    }
+}
+#endif /* TX_FRAME_NUM_SEGMENTS */
+
+/*
+ * Refill the UART FIFO from the message in flight. The buffer is released as soon as the last
+ * byte was handed over to the FIFO.
+ */
+static void serial_tx_isr(void)
+{
+    if (tx_buf_in_flight == NULL) {
+        uart_irq_tx_disable(uart_dev);
+        return;
     }
 
+#ifdef TX_FRAME_NUM_SEGMENTS
+    if (tx_frame) {
+        serial_tx_frame_isr();
+        return;
+    }
+#endif
+
+    uint8_t *data = tx_buf_in_flight->data;
+
 #ifdef CONFIG_THINGSET_SERIAL_USE_CRC
-    uint32_t crc = crc32_ieee(buf, len);
-    uint8_t crc_str[11];
-    snprintf(crc_str, sizeof(crc_str), " %08X#", crc);
-    for (int i = 0; i < 10; i++) {
-        uart_poll_out(uart_dev, crc_str[i]);
+    if (tx_pos < tx_crc_len) {
+        /* CRC is calculated chunk by chunk while the FIFO drains */
+        int filled = uart_fifo_fill(uart_dev, data + tx_pos, tx_crc_len - tx_pos);
+        tx_crc = crc32_ieee_update(tx_crc, data + tx_pos, filled);
+        tx_pos += filled;
+        if (tx_pos == tx_crc_len) {
+            serial_put_crc_trailer(data + tx_pos, tx_crc);
+        }
+        return;
     }
 #endif
 
-    uart_poll_out(uart_dev, '\r');
-    uart_poll_out(uart_dev, '\n');
+    tx_pos += uart_fifo_fill(uart_dev, data + tx_pos, tx_len - tx_pos);
+    if (tx_pos >= tx_len) {
+        uart_irq_tx_disable(uart_dev);
+        serial_tx_done();
+    }
+}
+#endif /* CONFIG_THINGSET_SERIAL_TX_INTERRUPT */
+
+static int serial_tx_queue(const struct serial_tx_msg *msg)
+{
+    if (serial_tx_lock(msg->buf) != 0) {
+        return -EBUSY;
+    }
+
+    /* wait for space in the queue if previous messages have not been sent yet */
+    if (k_msgq_put(&tx_queue, msg, K_MSEC(CONFIG_THINGSET_SERIAL_TX_TIMEOUT_MS)) != 0) {
+        k_mutex_unlock(&tx_mutex);
+        LOG_WRN("Discarded message because UART TX queue is full");
+        stats_inc(STATS_SERIAL, STATS_TIMEOUTS);
+        thingset_sdk_tx_buf_release(msg->buf);
+        return -EBUSY;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&tx_lock);
+    serial_tx_next();
+    k_spin_unlock(&tx_lock, key);
+
+    k_mutex_unlock(&tx_mutex);
 
     return 0;
 }
 
+static int serial_tx_start(struct shared_buffer *tx_buf, size_t len, size_t crc_len)
+{
+    struct serial_tx_msg msg = {
+        .buf = tx_buf,
+        .len = len,
+        .crc_len = crc_len,
+    };
+
+#if defined(CONFIG_THINGSET_SERIAL_TX_ASYNC) && defined(CONFIG_THINGSET_SERIAL_USE_CRC)
+    /* DMA needs the entire message in advance */
+    if (crc_len > 0) {
+        serial_put_crc_trailer(&tx_buf->data[crc_len], crc32_ieee(tx_buf->data, crc_len));
+    }
+#endif
+
+    int err = serial_tx_queue(&msg);
+    if (err == 0) {
+        stats_add(STATS_SERIAL, STATS_BYTES_OUT, len);
+    }
+
+    return err;
+}
+
+#ifdef TX_FRAME_NUM_SEGMENTS
+/* the number of bytes sent is counted by the ISR, as the frame length is not known in advance */
+static int serial_tx_start_frame(struct shared_buffer *tx_buf, size_t len)
+{
+    struct serial_tx_msg msg = {
+        .buf = tx_buf,
+        .len = len,
+        .frame = true,
+    };
+
+    return serial_tx_queue(&msg);
+}
+#endif
+
+static inline bool serial_tx_idle(void)
+{
+    return tx_buf_in_flight == NULL && k_msgq_num_used_get(&tx_queue) == 0;
+}
+
+/* wait until all queued messages were sent */
+static inline int serial_tx_wait_idle(k_timeout_t timeout)
+{
+    k_sem_reset(&tx_idle_sem);
+    if (serial_tx_idle()) {
+        return 0;
+    }
+
+    return k_sem_take(&tx_idle_sem, timeout);
+}
+
+#endif /* CONFIG_THINGSET_SERIAL_TX_POLLING */
+
+static int serial_send_text(struct shared_buffer *tx_buf, size_t len)
+{
+    size_t crc_len = 0;
+
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+    /* space for the CRC trailer, which is filled in during transmission */
+    crc_len = len;
+    len += 10;
+#endif
+    tx_buf->data[len++] = '\r';
+    tx_buf->data[len++] = '\n';
+
+    return serial_tx_start(tx_buf, len, crc_len);
+}
+
+#ifdef CONFIG_THINGSET_SERIAL_BINARY
+/*
+ * Binary messages are followed by the big-endian CRC-32 and sent as a SLIP-style frame using the
+ * same encoding as the Bluetooth interface. In multi-channel mode, the channel ID is prepended.
+ */
+static int serial_send_bin(struct shared_buffer *tx_buf, size_t len, uint8_t channel)
+{
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+    memmove(tx_buf->data + 1, tx_buf->data, len);
+    tx_buf->data[0] = channel;
+    len++;
+#endif
+
+    sys_put_be32(crc32_ieee(tx_buf->data, len), tx_buf->data + len);
+    len += 4;
+
+#ifdef TX_FRAME_NUM_SEGMENTS
+    return serial_tx_start_frame(tx_buf, len);
+#else
+    /* escaping may double the size in the worst case */
+    struct shared_buffer *frame_buf =
+        thingset_sdk_tx_buf_acquire(MIN(2 * len + 2, CONFIG_THINGSET_SHARED_TX_BUF_SIZE),
+                                    K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+    if (frame_buf == NULL) {
+        thingset_sdk_tx_buf_release(tx_buf);
+        return -EBUSY;
+    }
+
+    /* one byte reserved, as packetize may exceed the given size by one byte */
+    int pos = 0;
+    int frame_len = packetize(tx_buf->data, len, frame_buf->data, frame_buf->size - 1, &pos);
+
+    thingset_sdk_tx_buf_release(tx_buf);
+
+    if (pos != len + 1) {
+        /* end of frame was not reached */
+        LOG_WRN("Binary message with %zu bytes exceeds TX buffer", len);
+        thingset_sdk_tx_buf_release(frame_buf);
+        return -ENOMEM;
+    }
+
+    return serial_tx_start(frame_buf, frame_len, 0);
+#endif /* TX_FRAME_NUM_SEGMENTS */
+}
+#endif /* CONFIG_THINGSET_SERIAL_BINARY */
+
+/*
+ * Send the message stored in a pool buffer and release the buffer afterwards. The buffer must
+ * have TX_TRAILER_LEN bytes of space behind the message.
+ */
+static int serial_send_buf(struct shared_buffer *tx_buf, size_t len)
+{
+    if (len == 0 || len + TX_TRAILER_LEN > tx_buf->size) {
+        thingset_sdk_tx_buf_release(tx_buf);
+        return -ENOMEM;
+    }
+
+#ifdef CONFIG_THINGSET_SERIAL_BINARY
+    if (is_binary(tx_buf->data[0])) {
+        return serial_send_bin(tx_buf, len, THINGSET_SERIAL_CHANNEL_LOCAL);
+    }
+#endif
+
+    return serial_send_text(tx_buf, len);
+}
+
+int thingset_serial_send(const uint8_t *buf, size_t len)
+{
+    if (!device_is_ready(uart_dev)) {
+        return -ENODEV;
+    }
+
+    /* copy the message, as the caller may reuse its buffer before the transmission finished */
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire(
+        len + TX_TRAILER_LEN, K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+    if (tx_buf == NULL) {
+        return -EBUSY;
+    }
+
+    memcpy(tx_buf->data, buf, len);
+
+    return serial_send_buf(tx_buf, len);
+}
+
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+
+int thingset_serial_send_channel(enum thingset_serial_channel channel, const uint8_t *buf,
+                                 size_t len)
+{
+    if (channel == THINGSET_SERIAL_CHANNEL_LOCAL) {
+        return thingset_serial_send(buf, len);
+    }
+
+    if (!device_is_ready(uart_dev)) {
+        return -ENODEV;
+    }
+
+    /* log output must never delay other traffic, so it is dropped if no buffer is available */
+    k_timeout_t timeout = (channel == THINGSET_SERIAL_CHANNEL_LOG)
+                              ? K_NO_WAIT
+                              : K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS);
+
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire(len + TX_BIN_TRAILER_LEN, timeout);
+    if (tx_buf == NULL) {
+        return -EBUSY;
+    }
+
+    if (len == 0 || len + TX_BIN_TRAILER_LEN > tx_buf->size) {
+        thingset_sdk_tx_buf_release(tx_buf);
+        return -ENOMEM;
+    }
+
+    memcpy(tx_buf->data, buf, len);
+
+    return serial_send_bin(tx_buf, len, channel);
+}
+
+#endif /* CONFIG_THINGSET_SERIAL_CHANNELS */
+
 int thingset_serial_send_report(const char *path)
 {
-    struct shared_buffer *tx_buf = thingset_sdk_shared_buffer();
-    k_sem_take(&tx_buf->lock, K_FOREVER);
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire_policy(
+        CONFIG_THINGSET_SHARED_TX_BUF_SIZE, THINGSET_SDK_TX_BUF_WAIT,
+        K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+    if (tx_buf == NULL) {
+        return -EBUSY;
+    }
+
+    int len = thingset_report_path(&ts, tx_buf->data, tx_buf->size - TX_TRAILER_LEN, path,
+                                   report_format);
+    if (len <= 0) {
+        thingset_sdk_tx_buf_release(tx_buf);
+        return len < 0 ? len : -ENOMEM;
+    }
+
+    int ret = serial_send_buf(tx_buf, len);
+    if (ret == 0) {
+        stats_inc(STATS_SERIAL, STATS_REPORTS);
+    }
+
+    return ret;
+}
+
+int thingset_serial_send_report_handle(const struct thingset_report_handle *handle)
+{
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire_policy(
+        CONFIG_THINGSET_SHARED_TX_BUF_SIZE, THINGSET_SDK_TX_BUF_WAIT,
+        K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+    if (tx_buf == NULL) {
+        return -EBUSY;
+    }
+
+    int len = thingset_sdk_report_by_handle(handle, tx_buf->data, tx_buf->size - TX_TRAILER_LEN,
+                                            report_format);
+    if (len <= 0) {
+        thingset_sdk_tx_buf_release(tx_buf);
+        return len < 0 ? len : -ENOMEM;
+    }
+
+    int ret = serial_send_buf(tx_buf, len);
+    if (ret == 0) {
+        stats_inc(STATS_SERIAL, STATS_REPORTS);
+    }
+
+    return ret;
+}
+
+#ifdef CONFIG_THINGSET_SERIAL_REPORT_STREAMING
+
+/*
+ * Chunks after the first one are acquired while the ThingSet context is locked, so they must not
+ * wait for other users of the buffer pool. Only our own chunks still in transmission are waited
+ * for, as they don't need the context to be released.
+ */
+static struct shared_buffer *serial_stream_buf_acquire(void)
+{
+    struct shared_buffer *tx_buf =
+        thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SERIAL_REPORT_CHUNK_SIZE, K_NO_WAIT);
+    if (tx_buf == NULL
+        && serial_tx_wait_idle(K_MSEC(CONFIG_THINGSET_SERIAL_TX_TIMEOUT_MS)) == 0)
+    {
+        tx_buf = thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SERIAL_REPORT_CHUNK_SIZE, K_NO_WAIT);
+    }
+
+    return tx_buf;
+}
+
+int thingset_serial_send_report_stream(const struct thingset_report_handle *handle)
+{
+    const struct thingset_data_object *obj = handle->obj;
+    bool first_chunk = true;
+    int index = 0;
+    int ret;
+
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+    uint32_t crc = 0;
+#endif
+
+    if (obj == NULL) {
+        return -EINVAL;
+    }
+
+    if (obj->type != THINGSET_TYPE_SUBSET || report_format != THINGSET_TXT_NAMES_VALUES) {
+        /* only text mode subset reports can be encoded progressively */
+        return thingset_serial_send_report_handle(handle);
+    }
+
+    /* no other messages may be sent between the chunks */
+    if (k_mutex_lock(&tx_mutex, K_MSEC(CONFIG_THINGSET_SERIAL_TX_TIMEOUT_MS)) != 0) {
+        LOG_WRN("Discarded report because UART TX is busy");
+        stats_inc(STATS_SERIAL, STATS_TIMEOUTS);
+        return -EBUSY;
+    }
+
+    do {
+        struct shared_buffer *tx_buf;
+        if (first_chunk) {
+            tx_buf = thingset_sdk_tx_buf_acquire_policy(
+                CONFIG_THINGSET_SERIAL_REPORT_CHUNK_SIZE, THINGSET_SDK_TX_BUF_WAIT,
+                K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+        }
+        else {
+            tx_buf = serial_stream_buf_acquire();
+        }
+        if (tx_buf == NULL) {
+            if (!first_chunk) {
+                LOG_WRN("Aborted report stream because no TX buffer was available");
+                thingset_export_subsets_progressively_abort(&ts);
+            }
+            ret = -EBUSY;
+            goto out;
+        }
+
+        size_t size =
+            MIN(tx_buf->size, CONFIG_THINGSET_SERIAL_REPORT_CHUNK_SIZE) - TX_TRAILER_LEN;
+        size_t pos = 0;
+        size_t len = 0;
+
+        if (first_chunk) {
+            int header_len =
+                report_encode_header(tx_buf->data, size, handle, THINGSET_TXT_NAMES_VALUES);
+            if (header_len < 0) {
+                thingset_sdk_tx_buf_release(tx_buf);
+                ret = header_len;
+                goto out;
+            }
+            pos = header_len;
+        }
+
+        /* the ThingSet context stays locked until the last chunk was encoded */
+        ret = thingset_export_subsets_progressively(&ts, tx_buf->data + pos, size - pos,
+                                                    obj->data.subset, THINGSET_TXT_NAMES_VALUES,
+                                                    &index, &len);
+        if (ret < 0) {
+            LOG_ERR("Failed to encode report chunk: %d", ret);
+            thingset_sdk_tx_buf_release(tx_buf);
+            ret = -EINVAL;
+            goto out;
+        }
+        pos += len;
+        first_chunk = false;
 
-    int len =
-        thingset_report_path(&ts, tx_buf->data, tx_buf->size, path, THINGSET_TXT_NAMES_VALUES);
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+        /* CRC over all chunks of the message, appended to the last one */
+        crc = crc32_ieee_update(crc, tx_buf->data, pos);
+        if (ret == 0) {
+            serial_put_crc_trailer(&tx_buf->data[pos], crc);
+            pos += 10;
+        }
+#endif
+        if (ret == 0) {
+            tx_buf->data[pos++] = '\r';
+            tx_buf->data[pos++] = '\n';
+        }
 
-    int ret = thingset_serial_send(tx_buf->data, len);
+        /* the next chunk is encoded while this one is transmitted */
+        int err = serial_tx_start(tx_buf, pos, 0);
+        if (err != 0) {
+            if (ret > 0) {
+                thingset_export_subsets_progressively_abort(&ts);
+            }
+            ret = err;
+            goto out;
+        }
+    } while (ret > 0);
+
+    stats_inc(STATS_SERIAL, STATS_REPORTS);
+
+out:
+    k_mutex_unlock(&tx_mutex);
 
-    k_sem_give(&tx_buf->lock);
     return ret;
 }
 
+#endif /* CONFIG_THINGSET_SERIAL_REPORT_STREAMING */
+
 #ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
 
-static void serial_regular_report_handler(struct k_work *work)
+static int serial_report_sink_send(struct thingset_report_sink *sink, const uint8_t *buf,
+                                   size_t len)
 {
-    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-    static int64_t pub_time;
+    int ret = thingset_serial_send(buf, len);
+    if (ret == 0) {
+        stats_inc(STATS_SERIAL, STATS_REPORTS);
+    }
+
+    return ret;
+}
+
+static struct thingset_report_sink report_sink = {
+    .format = THINGSET_TXT_NAMES_VALUES,
+    .send = serial_report_sink_send,
+};
+
+#endif
+
+#ifdef CONFIG_THINGSET_SERIAL_BAUD_NEGOTIATION
+
+static uint32_t baudrate_requested;
+
+/* configuration used before the switch, restored if the new baud rate is not confirmed */
+static struct uart_config uart_cfg_fallback;
+
+static int32_t serial_set_baudrate(void);
+static void serial_baud_switch_handler(struct k_work *work);
+static void serial_baud_fallback_handler(struct k_work *work);
 
-    if (live_reporting_enable) {
-        thingset_serial_send_report(TS_NAME_SUBSET_LIVE);
+THINGSET_ADD_FN_INT32(TS_ID_NET, TS_ID_NET_SERIAL_SET_BAUDRATE, "xSerialBaudrate",
+                      &serial_set_baudrate, THINGSET_ANY_RW);
+THINGSET_ADD_ITEM_UINT32(TS_ID_NET_SERIAL_SET_BAUDRATE, TS_ID_NET_SERIAL_BAUDRATE, "nBaudrate",
+                         &baudrate_requested, THINGSET_ANY_RW, 0);
+
+K_WORK_DELAYABLE_DEFINE(baud_switch_work, serial_baud_switch_handler);
+K_WORK_DELAYABLE_DEFINE(baud_fallback_work, serial_baud_fallback_handler);
+
+static int32_t serial_set_baudrate(void)
+{
+    if (baudrate_requested == 0) {
+        return -EINVAL;
+    }
+
+    /* keep falling back to the last confirmed configuration if the previous switch is pending */
+    if (k_work_delayable_busy_get(&baud_fallback_work) == 0) {
+        int err = uart_config_get(uart_dev, &uart_cfg_fallback);
+        if (err != 0) {
+            LOG_ERR("Failed to get UART configuration (err %d)", err);
+            return err;
+        }
     }
 
-    pub_time += live_reporting_period;
-    thingset_sdk_reschedule_work(dwork, K_TIMEOUT_ABS_MS(pub_time));
+    /* switch after the response was sent with the current baud rate */
+    thingset_sdk_reschedule_work(&baud_switch_work, K_NO_WAIT);
+
+    return 0;
 }
 
+/*
+ * Check if all messages were sent and the last bytes left the UART FIFO and shift register.
+ *
+ * Returns 1 if drained, 0 if not and -ENOTSUP if only the TX queue could be checked.
+ */
+static int serial_tx_drained(void)
+{
+    if (!serial_tx_idle()) {
+        return 0;
+    }
+
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+    /* negative if not supported by the driver */
+    int ret = uart_irq_tx_complete(uart_dev);
+    return ret < 0 ? -ENOTSUP : ret != 0;
+#else
+    return -ENOTSUP;
 #endif
+}
 
-static void serial_process_msg_handler(struct k_work *work)
+static void serial_baud_switch_handler(struct k_work *work)
 {
-    if (rx_buf_pos > 0) {
-        LOG_DBG("Received Request (%d bytes): %s", rx_buf_pos, rx_buf);
+    static bool char_time_waited;
+
+    int drained = serial_tx_drained();
+    if (drained == 0) {
+        /* check again without blocking the work queue */
+        char_time_waited = false;
+        thingset_sdk_reschedule_work(&baud_switch_work, K_MSEC(1));
+        return;
+    }
+    else if (drained < 0 && !char_time_waited) {
+        /*
+         * The last byte may still be shifted out, so wait for one character time (up to 12 bits
+         * including start, parity and stop bits) at the previous baud rate.
+         */
+        char_time_waited = true;
+        thingset_sdk_reschedule_work(&baud_switch_work,
+                                     K_USEC(12 * USEC_PER_SEC / uart_cfg_fallback.baudrate + 1));
+        return;
+    }
+    char_time_waited = false;
+
+    struct uart_config cfg = uart_cfg_fallback;
+    cfg.baudrate = baudrate_requested;
 
+    int err = uart_configure(uart_dev, &cfg);
+    if (err != 0) {
+        LOG_ERR("Failed to set baud rate %u (err %d)", baudrate_requested, err);
+        return;
+    }
+
+    LOG_INF("Switched to %u baud", baudrate_requested);
+
+    /* the host has to confirm the new baud rate with a valid request */
+    thingset_sdk_reschedule_work(&baud_fallback_work,
+                                 K_MSEC(CONFIG_THINGSET_SERIAL_BAUD_TIMEOUT_MS));
+}
+
+static void serial_baud_fallback_handler(struct k_work *work)
+{
+    LOG_WRN("No valid message received at %u baud, falling back to %u baud", baudrate_requested,
+            uart_cfg_fallback.baudrate);
+
+    uart_configure(uart_dev, &uart_cfg_fallback);
+}
+
+#endif /* CONFIG_THINGSET_SERIAL_BAUD_NEGOTIATION */
+
+#if defined(CONFIG_THINGSET_SERIAL_USE_CRC) || defined(CONFIG_THINGSET_SERIAL_BINARY)
+/* add the remaining bytes to the CRC calculated during reception */
+static uint32_t serial_rx_crc_finish(struct serial_rx_buf *buf)
+{
+    return crc32_ieee_update(buf->crc, buf->data + buf->crc_len, buf->len - buf->crc_len);
+}
+#endif
+
+/* validate and strip the optional CRC of a text mode request */
+static bool serial_check_text_crc(struct serial_rx_buf *buf)
+{
 #ifdef CONFIG_THINGSET_SERIAL_USE_CRC
-        if (rx_buf[rx_buf_pos - 1] == '#' && rx_buf_pos > 10) {
-            /* message with checksum */
-            rx_buf[--rx_buf_pos] = '\0';
-            uint32_t crc_rx = strtoul(&rx_buf[rx_buf_pos - 8], NULL, 16);
-            rx_buf_pos -= 9; /* strip CRC and white space */
-            uint32_t crc_calc = crc32_ieee(rx_buf, rx_buf_pos);
-            if (crc_rx != crc_calc) {
-                LOG_WRN("Discarded message with bad CRC, expected %08X", crc_calc);
-                goto out;
-            }
-            LOG_DBG("crc_rx: %08X, crc_calc: %08X", crc_rx, crc_calc);
+    if (buf->data[buf->len - 1] == '#' && buf->len > 10) {
+        /* message with checksum */
+        uint8_t crc_bytes[4];
+        uint32_t crc_rx = 0;
+        if (hex2bin(&buf->data[buf->len - 9], 8, crc_bytes, sizeof(crc_bytes)) == 4) {
+            crc_rx = sys_get_be32(crc_bytes);
+        }
+        buf->len -= 10; /* strip CRC and white space */
+        buf->data[buf->len] = '\0';
+        uint32_t crc_calc = serial_rx_crc_finish(buf);
+        if (crc_rx != crc_calc) {
+            LOG_WRN("Discarded message with bad CRC, expected %08X", crc_calc);
+            return false;
         }
+        LOG_DBG("crc_rx: %08X, crc_calc: %08X", crc_rx, crc_calc);
+    }
 #endif /* CONFIG_THINGSET_SERIAL_USE_CRC */
 #ifdef CONFIG_THINGSET_SERIAL_ENFORCE_CRC
+    else {
+        LOG_WRN("Discarded message without CRC");
+        return false;
+    }
+#endif /* CONFIG_THINGSET_SERIAL_ENFORCE_CRC */
+
+    return true;
+}
+
+#ifdef CONFIG_THINGSET_SERIAL_BINARY
+/* validate and strip the mandatory CRC of a binary request */
+static bool serial_check_bin_crc(struct serial_rx_buf *buf)
+{
+    if (buf->len <= 4) {
+        LOG_WRN("Discarded binary message without CRC");
+        return false;
+    }
+
+    buf->len -= 4;
+    uint32_t crc_rx = sys_get_be32(&buf->data[buf->len]);
+    uint32_t crc_calc = serial_rx_crc_finish(buf);
+    if (crc_rx != crc_calc) {
+        LOG_WRN("Discarded binary message with bad CRC, expected %08X", crc_calc);
+        return false;
+    }
+
+    return true;
+}
+#endif /* CONFIG_THINGSET_SERIAL_BINARY */
+
+#ifndef CONFIG_THINGSET_SERIAL_TX_POLLING
+/*
+ * Responses are encoded into a large buffer, but queued in the smallest free buffer they fit in,
+ * so that large buffers are not pinned in the TX queue while other interfaces need them.
+ */
+static struct shared_buffer *serial_tx_buf_shrink(struct shared_buffer *tx_buf, size_t len)
+{
+    struct shared_buffer *fit_buf = thingset_sdk_tx_buf_acquire(len + TX_TRAILER_LEN, K_NO_WAIT);
+    if (fit_buf == NULL) {
+        return tx_buf;
+    }
+
+    if (fit_buf->size >= tx_buf->size) {
+        thingset_sdk_tx_buf_release(fit_buf);
+        return tx_buf;
+    }
+
+    memcpy(fit_buf->data, tx_buf->data, len);
+    thingset_sdk_tx_buf_release(tx_buf);
+
+    return fit_buf;
+}
+#endif
+
+static void serial_process_msg(struct serial_rx_buf *buf)
+{
+    uint32_t t_start = stats_timestamp();
+    bool crc_valid;
+
+    stats_inc(STATS_SERIAL, STATS_REQUESTS);
+
+#ifdef CONFIG_THINGSET_SERIAL_BINARY
+    if (buf->binary) {
+        LOG_DBG("Received binary request (%d bytes)", buf->len);
+        crc_valid = serial_check_bin_crc(buf);
+    }
+    else
+#endif
+    {
+        LOG_DBG("Received Request (%d bytes): %s", buf->len, buf->data);
+        crc_valid = serial_check_text_crc(buf);
+    }
+
+    if (!crc_valid) {
+        stats_inc(STATS_SERIAL, STATS_CRC_ERRORS);
+        return;
+    }
+
+#ifdef CONFIG_THINGSET_SERIAL_BAUD_NEGOTIATION
+    /* valid message confirms a new baud rate */
+    k_work_cancel_delayable(&baud_fallback_work);
+#endif
+
+    uint8_t *msg = (uint8_t *)buf->data;
+    size_t msg_len = buf->len;
+
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+    if (buf->binary) {
+        /* strip the channel ID */
+        msg++;
+        msg_len--;
+    }
+
+    if (msg_len == 0) {
+        return;
+    }
+
+    if (buf->channel == THINGSET_SERIAL_CHANNEL_GATEWAY) {
+        if (rx_callback != NULL) {
+            rx_callback(msg, msg_len);
+        }
         else {
-            LOG_WRN("Discarded message without CRC");
-            goto out;
+            LOG_DBG("Discarded gateway message because no callback is set");
         }
-#endif /* CONFIG_THINGSET_SERIAL_ENFORCE_CRC */
+        return;
+    }
+
+    /* messages on the local channel are always processed by the local node */
+    bool forward = false;
+#else
+    bool forward = (rx_callback != NULL);
+#endif
+
+#ifdef CONFIG_THINGSET_SERIAL_BINARY
+    report_format = buf->binary && is_binary(msg[0]) ? THINGSET_BIN_IDS_VALUES
+                                                     : THINGSET_TXT_NAMES_VALUES;
+#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
+    /* sinks are only accessed from the SDK work queue, which also runs this handler */
+    report_sink.format = report_format;
+#endif
+#endif
 
-        if (rx_callback == NULL) {
-            struct shared_buffer *tx_buf = thingset_sdk_shared_buffer();
-            k_sem_take(&tx_buf->lock, K_FOREVER);
+    if (!forward) {
+        struct shared_buffer *tx_buf =
+            thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SHARED_TX_BUF_SIZE, K_FOREVER);
 
-            int len = thingset_process_message(&ts, (uint8_t *)rx_buf, rx_buf_pos, tx_buf->data,
-                                               tx_buf->size);
-            if (len > 0) {
-                thingset_serial_send(tx_buf->data, len);
+        int len = thingset_sdk_process_message(msg, msg_len, tx_buf->data,
+                                               tx_buf->size - TX_TRAILER_LEN);
+        if (len > 0) {
+#ifndef CONFIG_THINGSET_SERIAL_TX_POLLING
+            tx_buf = serial_tx_buf_shrink(tx_buf, len);
+#endif
+            /* buffer is released by the driver after the transmission */
+            if (serial_send_buf(tx_buf, len) == 0) {
+                stats_inc(STATS_SERIAL, STATS_RESPONSES);
             }
-
-            k_sem_give(&tx_buf->lock);
         }
         else {
-            /* external processing (e.g. for gateway applications) */
-            rx_callback(rx_buf, rx_buf_pos);
+            thingset_sdk_tx_buf_release(tx_buf);
         }
+
+        stats_record_latency(STATS_SERIAL, buf->timestamp, t_start, stats_timestamp());
     }
+    else {
+        /* external processing (e.g. for gateway applications) */
+        rx_callback(msg, msg_len);
+    }
+}
 
-out:
-    /* release buffer and start waiting for new commands */
-    rx_buf_pos = 0;
-    k_sem_give(&rx_buf_lock);
+static void serial_rx_buf_reset(struct serial_rx_buf *buf)
+{
+    buf->len = 0;
+    buf->binary = false;
+    buf->crc = 0;
+    buf->crc_len = 0;
 }
 
+static void serial_process_msg_handler(struct k_work *work)
+{
+    struct serial_rx_buf *buf;
+
+    /* process all queued requests, new ones may arrive in the meantime */
+    while (k_msgq_get(&rx_ready_queue, &buf, K_NO_WAIT) == 0) {
+        serial_process_msg(buf);
+
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+        atomic_dec(&rx_pending[buf->channel]);
+#endif
+        serial_rx_buf_reset(buf);
+        k_msgq_put(&rx_free_queue, &buf, K_NO_WAIT);
+    }
+}
+
+/* add bytes to the CRC as soon as they are lagging enough behind the end of the message */
+static inline void serial_rx_crc_update(size_t lag)
+{
+    while (rx_buf->crc_len + lag < rx_buf->len) {
+        rx_buf->crc = crc32_ieee_update(rx_buf->crc, &rx_buf->data[rx_buf->crc_len], 1);
+        rx_buf->crc_len++;
+    }
+}
+
+/* hand a complete request over for processing and continue with the next free buffer */
+static void serial_rx_buf_complete(void)
+{
+    if (rx_buf->len > 0) {
+        rx_buf->data[rx_buf->len] = '\0';
+        rx_buf->timestamp = stats_timestamp();
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+        atomic_inc(&rx_pending[rx_buf->channel]);
+#endif
+        k_msgq_put(&rx_ready_queue, &rx_buf, K_NO_WAIT);
+        rx_buf = NULL;
+        thingset_sdk_reschedule_work(&processing_work, K_NO_WAIT);
+    }
+}
+
+#ifdef CONFIG_THINGSET_SERIAL_BINARY
+/* decode the SLIP-style framing of binary requests (see packetizer.h) */
+static void serial_rx_bin_put(uint8_t c)
+{
+    if (rx_escape) {
+        rx_escape = false;
+        if (c == MSG_ESC_END) {
+            c = MSG_END;
+        }
+        else if (c == MSG_ESC_SKIP) {
+            c = MSG_SKIP;
+        }
+        else if (c == MSG_ESC_ESC) {
+            c = MSG_ESC;
+        }
+        /* else: protocol violation, pass character as is */
+    }
+    else if (c == MSG_ESC) {
+        rx_escape = true;
+        return;
+    }
+    else if (c == MSG_SKIP) {
+        return;
+    }
+    else if (c == MSG_END) {
+        serial_rx_buf_complete();
+        return;
+    }
+
+    // oversized messages are truncated and discarded due to a CRC mismatch
+    if (rx_buf->len < (sizeof(rx_buf->data) - 1)) {
+        rx_buf->data[rx_buf->len++] = c;
+        serial_rx_crc_update(RX_BIN_CRC_LAG);
+    }
+}
+#endif /* CONFIG_THINGSET_SERIAL_BINARY */
+
 static void serial_rx_buf_put(uint8_t c)
 {
-    if (k_sem_take(&rx_buf_lock, K_NO_WAIT) != 0) {
-        // buffer not available: drop character
+    stats_inc(STATS_SERIAL, STATS_BYTES_IN);
+
+    if (rx_buf == NULL && k_msgq_get(&rx_free_queue, &rx_buf, K_NO_WAIT) != 0) {
+        /* all buffers are waiting to be processed: drop the request */
+        rx_buf = NULL;
         discard_buffer = true;
-        return;
     }
 
     // \r\n and \n are markers for line end, i.e. request end
     // we accept this at any time, even if the buffer is 'full', since
     // there is always one last character left for the \0
-    if (c == '\n') {
-        if (rx_buf_pos > 0 && rx_buf[rx_buf_pos - 1] == '\r') {
-            rx_buf[--rx_buf_pos] = '\0';
+    // (binary frames are also terminated by \n, which is the SLIP end byte)
+    if (c == '\n' && discard_buffer) {
+        if (discarded_data || (rx_buf != NULL && rx_buf->len > 0)) {
+            LOG_DBG("Discarded request because RX queue is full");
+            stats_inc(STATS_SERIAL, STATS_RX_DROPPED);
         }
-        else {
-            rx_buf[rx_buf_pos] = '\0';
+        discard_buffer = false;
+        discarded_data = false;
+        if (rx_buf != NULL) {
+            serial_rx_buf_reset(rx_buf);
         }
-        if (discard_buffer) {
-            rx_buf_pos = 0;
-            discard_buffer = false;
-            k_sem_give(&rx_buf_lock);
+        return;
+    }
+    else if (discard_buffer) {
+        if (c != '\r') {
+            discarded_data = true;
         }
-        else {
-            // start processing request and keep the rx_buf_lock
-            thingset_sdk_reschedule_work(&processing_work, K_NO_WAIT);
+        return;
+    }
+
+#ifdef CONFIG_THINGSET_SERIAL_BINARY
+    if (rx_buf->len == 0 && !rx_buf->binary && c != '\r' && c != '\n') {
+        /* the first byte of each message determines the framing */
+        rx_buf->binary = is_binary_rx_start(c);
+        rx_escape = false;
+
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+        /* the first byte of binary frames is the channel ID */
+        rx_buf->channel = rx_buf->binary ? c : THINGSET_SERIAL_CHANNEL_LOCAL;
+        if (atomic_get(&rx_pending[rx_buf->channel]) >= CONFIG_THINGSET_SERIAL_RX_BUF_COUNT) {
+            /* all buffers of this channel are waiting to be processed */
+            discard_buffer = true;
+            discarded_data = true;
+            return;
         }
+#endif
+    }
+
+    if (rx_buf->binary) {
+        serial_rx_bin_put(c);
         return;
     }
+#endif
+
+    if (c == '\n') {
+        if (rx_buf->len > 0 && rx_buf->data[rx_buf->len - 1] == '\r') {
+            rx_buf->len--;
+        }
+        serial_rx_buf_complete();
+    }
     // backspace allowed if there is something in the buffer already
-    else if (rx_buf_pos > 0 && c == '\b') {
-        rx_buf_pos--;
+    else if (rx_buf->len > 0 && c == '\b') {
+        rx_buf->len--;
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+        if (rx_buf->len < rx_buf->crc_len) {
+            /* deleted byte was already added to the CRC, so it is calculated again from scratch */
+            rx_buf->crc = 0;
+            rx_buf->crc_len = 0;
+        }
+#endif
     }
     // Fill the buffer up to all but 1 character (the last character is reserved for '\0')
     // Characters beyond the size of the buffer are dropped.
-    else if (rx_buf_pos < (sizeof(rx_buf) - 1)) {
-        rx_buf[rx_buf_pos++] = c;
+    else if (rx_buf->len < (sizeof(rx_buf->data) - 1)) {
+        rx_buf->data[rx_buf->len++] = c;
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+        serial_rx_crc_update(RX_TEXT_CRC_LAG);
+#endif
     }
-
-    k_sem_give(&rx_buf_lock);
 }
 
-#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+#ifdef CONFIG_THINGSET_SERIAL_RX_INTERRUPT
 /*
  * Read characters from stream until line end \n is detected, afterwards signal available command.
  */
@@ -206,8 +1308,65 @@ static void serial_rx_cb(const struct device *dev, void *user_data)
         uart_fifo_read(uart_dev, &c, 1);
         serial_rx_buf_put(c);
     }
+
+#ifdef CONFIG_THINGSET_SERIAL_TX_INTERRUPT
+    if (uart_irq_tx_ready(uart_dev)) {
+        serial_tx_isr();
+    }
+#endif
+}
+#endif
+
+#ifdef CONFIG_THINGSET_SERIAL_RX_ASYNC
+/* DMA buffers used alternately by the driver */
+static uint8_t rx_dma_bufs[2][CONFIG_THINGSET_SERIAL_RX_DMA_BUF_SIZE];
+static int rx_dma_next;
+
+static int serial_rx_async_start(void)
+{
+    rx_dma_next = 1;
+
+    /* data is reported after the line was idle for the timeout or if a DMA buffer is full */
+    return uart_rx_enable(uart_dev, rx_dma_bufs[0], sizeof(rx_dma_bufs[0]),
+                          CONFIG_THINGSET_SERIAL_RX_IDLE_TIMEOUT_US);
 }
+#endif /* CONFIG_THINGSET_SERIAL_RX_ASYNC */
+
+#if defined(CONFIG_THINGSET_SERIAL_RX_ASYNC) || defined(CONFIG_THINGSET_SERIAL_TX_ASYNC)
+static void serial_async_cb(const struct device *dev, struct uart_event *evt, void *user_data)
+{
+    switch (evt->type) {
+#ifdef CONFIG_THINGSET_SERIAL_TX_ASYNC
+        case UART_TX_DONE:
+        case UART_TX_ABORTED:
+            serial_tx_done();
+            break;
 #endif
+#ifdef CONFIG_THINGSET_SERIAL_RX_ASYNC
+        case UART_RX_RDY:
+            for (size_t i = 0; i < evt->data.rx.len; i++) {
+                serial_rx_buf_put(evt->data.rx.buf[evt->data.rx.offset + i]);
+            }
+            break;
+        case UART_RX_BUF_REQUEST:
+            uart_rx_buf_rsp(dev, rx_dma_bufs[rx_dma_next], sizeof(rx_dma_bufs[0]));
+            rx_dma_next ^= 1;
+            break;
+        case UART_RX_STOPPED:
+            /* RX error (e.g. overrun): the current request is incomplete */
+            discard_buffer = true;
+            discarded_data = true;
+            break;
+        case UART_RX_DISABLED:
+            /* restart reception after errors */
+            serial_rx_async_start();
+            break;
+#endif
+        default:
+            break;
+    }
+}
+#endif /* CONFIG_THINGSET_SERIAL_RX_ASYNC || CONFIG_THINGSET_SERIAL_TX_ASYNC */
 
 void thingset_serial_set_rx_callback(thingset_sdk_rx_callback_t rx_cb)
 {
@@ -222,21 +1381,36 @@ static int thingset_serial_init()
         return -ENODEV;
     }
 
-    k_sem_init(&rx_buf_lock, 1, 1);
+    for (int i = 0; i < ARRAY_SIZE(rx_bufs); i++) {
+        struct serial_rx_buf *buf = &rx_bufs[i];
+        k_msgq_put(&rx_free_queue, &buf, K_NO_WAIT);
+    }
 
     k_work_init_delayable(&processing_work, serial_process_msg_handler);
 
-#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-    k_work_init_delayable(&reporting_work, serial_regular_report_handler);
+#if defined(CONFIG_THINGSET_SERIAL_RX_ASYNC) || defined(CONFIG_THINGSET_SERIAL_TX_ASYNC)
+    int err = uart_callback_set(uart_dev, serial_async_cb, NULL);
+    if (err != 0) {
+        LOG_ERR("UART async API not supported: %d", err);
+        return err;
+    }
 #endif
 
-#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+#ifdef CONFIG_THINGSET_SERIAL_RX_ASYNC
+    err = serial_rx_async_start();
+    if (err != 0) {
+        LOG_ERR("Failed to enable UART RX: %d", err);
+        return err;
+    }
+#endif
+
+#ifdef CONFIG_THINGSET_SERIAL_RX_INTERRUPT
     uart_irq_callback_user_data_set(uart_dev, serial_rx_cb, NULL);
     uart_irq_rx_enable(uart_dev);
 #endif
 
 #ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-    thingset_sdk_reschedule_work(&reporting_work, K_NO_WAIT);
+    thingset_sdk_register_report_sink(&report_sink);
 #endif
 
     return 0;
@@ -244,7 +1418,7 @@ static int thingset_serial_init()
 
 SYS_INIT(thingset_serial_init, APPLICATION, THINGSET_INIT_PRIORITY_DEFAULT);
 
-#ifndef CONFIG_UART_INTERRUPT_DRIVEN
+#ifdef CONFIG_THINGSET_SERIAL_RX_POLLING
 static void thingset_serial_polling_thread()
 {
     if (!device_is_ready(uart_dev)) {
@@ -17,10 +17,6 @@
 
 static uint8_t req_buf[CONFIG_SHELL_CMD_BUFF_SIZE];
 
-#if defined(CONFIG_THINGSET_SHELL_REPORTING) && defined(CONFIG_THINGSET_SUBSET_LIVE_METRICS)
-static struct k_work_delayable reporting_work;
-#endif
-
 static int cmd_thingset(const struct shell *shell, size_t argc, char **argv)
 {
     size_t pos = 0;
@@ -34,17 +30,17 @@ static int cmd_thingset(const struct shell *shell, size_t argc, char **argv)
     }
     req_buf[--pos] = '\0';
 
-    struct shared_buffer *rsp_buf = thingset_sdk_shared_buffer();
-    k_sem_take(&rsp_buf->lock, K_FOREVER);
+    struct shared_buffer *rsp_buf =
+        thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SHARED_TX_BUF_SIZE, K_FOREVER);
 
-    int len = thingset_process_message(&ts, (uint8_t *)req_buf, strlen(req_buf), rsp_buf->data,
-                                       rsp_buf->size);
+    int len = thingset_sdk_process_message((uint8_t *)req_buf, strlen(req_buf), rsp_buf->data,
+                                           rsp_buf->size);
 
     if (len > 0) {
         shell_print(shell, "%s", rsp_buf->data);
     }
 
-    k_sem_give(&rsp_buf->lock);
+    thingset_sdk_tx_buf_release(rsp_buf);
 
     return 0;
 }
@@ -53,33 +49,23 @@ SHELL_CMD_ARG_REGISTER(thingset, NULL, "ThingSet request", cmd_thingset, 1, 10);
 
 #if defined(CONFIG_THINGSET_SHELL_REPORTING) && defined(CONFIG_THINGSET_SUBSET_LIVE_METRICS)
 
-static void shell_regular_report_handler(struct k_work *work)
+static int shell_report_sink_send(struct thingset_report_sink *sink, const uint8_t *buf, size_t len)
 {
-    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
     const struct shell *sh = shell_backend_uart_get_ptr();
-    static int64_t pub_time;
-
-    if (live_reporting_enable) {
-        struct shared_buffer *tx_buf = thingset_sdk_shared_buffer();
-        k_sem_take(&tx_buf->lock, K_FOREVER);
-
-        int len = thingset_report_path(&ts, tx_buf->data, tx_buf->size, TS_NAME_SUBSET_LIVE,
-                                       THINGSET_TXT_NAMES_VALUES);
-        if (len > 0) {
-            shell_print(sh, "%.*s", tx_buf->size, tx_buf->data);
-        }
 
-        k_sem_give(&tx_buf->lock);
-    }
+    shell_print(sh, "%.*s", (int)len, buf);
 
-    pub_time += live_reporting_period;
-    thingset_sdk_reschedule_work(dwork, K_TIMEOUT_ABS_MS(pub_time));
+    return 0;
 }
 
+static struct thingset_report_sink report_sink = {
+    .format = THINGSET_TXT_NAMES_VALUES,
+    .send = shell_report_sink_send,
+};
+
 static int thingset_shell_init()
 {
-    k_work_init_delayable(&reporting_work, shell_regular_report_handler);
-    thingset_sdk_reschedule_work(&reporting_work, K_NO_WAIT);
+    thingset_sdk_register_report_sink(&report_sink);
 
     return 0;
 }
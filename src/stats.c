@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) The ThingSet Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include <thingset.h>
+#include <thingset/sdk.h>
+
+#include "stats.h"
+
+atomic_t thingset_stats[STATS_NUM_IFACES][STATS_NUM_COUNTERS];
+
+/* copy of the counters, so that all values of a group are consistent while being encoded */
+static uint32_t snapshot[STATS_NUM_IFACES][STATS_NUM_COUNTERS];
+
+#ifdef CONFIG_THINGSET_STATS_LATENCY
+
+#define NUM_BUCKETS CONFIG_THINGSET_STATS_LATENCY_BUCKETS
+
+static atomic_t queue_delay_hist[STATS_NUM_IFACES][NUM_BUCKETS];
+static atomic_t service_time_hist[STATS_NUM_IFACES][NUM_BUCKETS];
+
+static uint32_t queue_delay_snapshot[STATS_NUM_IFACES][NUM_BUCKETS];
+static uint32_t service_time_snapshot[STATS_NUM_IFACES][NUM_BUCKETS];
+
+static int latency_bucket(uint32_t start, uint32_t end)
+{
+    uint32_t us = k_cyc_to_us_floor32(end - start);
+
+    /* bucket n contains latencies from 2^n to 2^(n+1) - 1 us, bucket 0 also contains 0 us */
+    int bucket = (us < 2) ? 0 : 31 - __builtin_clz(us);
+
+    return MIN(bucket, NUM_BUCKETS - 1);
+}
+
+void stats_record_latency(enum stats_iface iface, uint32_t t_arrival, uint32_t t_start,
+                          uint32_t t_done)
+{
+    atomic_inc(&queue_delay_hist[iface][latency_bucket(t_arrival, t_start)]);
+    atomic_inc(&service_time_hist[iface][latency_bucket(t_start, t_done)]);
+}
+
+#endif /* CONFIG_THINGSET_STATS_LATENCY */
+
+static void stats_read_cb(enum thingset_callback_reason reason)
+{
+    if (reason == THINGSET_CALLBACK_PRE_READ) {
+        for (int i = 0; i < STATS_NUM_IFACES; i++) {
+            for (int j = 0; j < STATS_NUM_COUNTERS; j++) {
+                snapshot[i][j] = atomic_get(&thingset_stats[i][j]);
+            }
+#ifdef CONFIG_THINGSET_STATS_LATENCY
+            for (int j = 0; j < NUM_BUCKETS; j++) {
+                queue_delay_snapshot[i][j] = atomic_get(&queue_delay_hist[i][j]);
+                service_time_snapshot[i][j] = atomic_get(&service_time_hist[i][j]);
+            }
+#endif
+        }
+    }
+}
+
+static int32_t stats_reset(void)
+{
+    for (int i = 0; i < STATS_NUM_IFACES; i++) {
+        for (int j = 0; j < STATS_NUM_COUNTERS; j++) {
+            atomic_clear(&thingset_stats[i][j]);
+        }
+#ifdef CONFIG_THINGSET_STATS_LATENCY
+        for (int j = 0; j < NUM_BUCKETS; j++) {
+            atomic_clear(&queue_delay_hist[i][j]);
+            atomic_clear(&service_time_hist[i][j]);
+        }
+#endif
+    }
+
+    return 0;
+}
+
+#ifdef CONFIG_THINGSET_STATS_LATENCY
+#define STATS_ADD_LATENCY(iface, group_id, queue_delay_id, service_time_id)                       \
+    static THINGSET_DEFINE_UINT32_ARRAY(queue_delay_##iface, 0, queue_delay_snapshot[iface],      \
+                                        NUM_BUCKETS);                                             \
+    static THINGSET_DEFINE_UINT32_ARRAY(service_time_##iface, 0, service_time_snapshot[iface],    \
+                                        NUM_BUCKETS);                                             \
+    THINGSET_ADD_ITEM_ARRAY(group_id, queue_delay_id, "rQueueDelayHist", &queue_delay_##iface,     \
+                            THINGSET_ANY_R, 0);                                                   \
+    THINGSET_ADD_ITEM_ARRAY(group_id, service_time_id, "rServiceTimeHist", &service_time_##iface,  \
+                            THINGSET_ANY_R, 0);
+#else
+#define STATS_ADD_LATENCY(iface, group_id, queue_delay_id, service_time_id)
+#endif
+
+/* adds the group of one interface with all its counters */
+#define STATS_ADD_IFACE(iface, group_id, name)                                                    \
+    STATS_ADD_LATENCY(iface, group_id, group_id##_QUEUE_DELAY, group_id##_SERVICE_TIME)           \
+    THINGSET_ADD_GROUP(TS_ID_STATS, group_id, name, stats_read_cb);                               \
+    THINGSET_ADD_ITEM_UINT32(group_id, group_id##_REQUESTS, "rRequests",                          \
+                             &snapshot[iface][STATS_REQUESTS], THINGSET_ANY_R, 0);                \
+    THINGSET_ADD_ITEM_UINT32(group_id, group_id##_RESPONSES, "rResponses",                        \
+                             &snapshot[iface][STATS_RESPONSES], THINGSET_ANY_R, 0);               \
+    THINGSET_ADD_ITEM_UINT32(group_id, group_id##_REPORTS, "rReports",                            \
+                             &snapshot[iface][STATS_REPORTS], THINGSET_ANY_R, 0);                 \
+    THINGSET_ADD_ITEM_UINT32(group_id, group_id##_BYTES_IN, "rBytesIn",                           \
+                             &snapshot[iface][STATS_BYTES_IN], THINGSET_ANY_R, 0);                \
+    THINGSET_ADD_ITEM_UINT32(group_id, group_id##_BYTES_OUT, "rBytesOut",                         \
+                             &snapshot[iface][STATS_BYTES_OUT], THINGSET_ANY_R, 0);               \
+    THINGSET_ADD_ITEM_UINT32(group_id, group_id##_RX_DROPPED, "rDroppedRx",                       \
+                             &snapshot[iface][STATS_RX_DROPPED], THINGSET_ANY_R, 0);              \
+    THINGSET_ADD_ITEM_UINT32(group_id, group_id##_CRC_ERRORS, "rCrcErrors",                       \
+                             &snapshot[iface][STATS_CRC_ERRORS], THINGSET_ANY_R, 0);              \
+    THINGSET_ADD_ITEM_UINT32(group_id, group_id##_TIMEOUTS, "rTimeouts",                          \
+                             &snapshot[iface][STATS_TIMEOUTS], THINGSET_ANY_R, 0)
+
+THINGSET_ADD_GROUP(TS_ID_ROOT, TS_ID_STATS, "_Stats", THINGSET_NO_CALLBACK);
+
+THINGSET_ADD_FN_INT32(TS_ID_STATS, TS_ID_STATS_RESET, "xReset", &stats_reset, THINGSET_ANY_RW);
+
+#ifdef CONFIG_THINGSET_SERIAL
+STATS_ADD_IFACE(STATS_SERIAL, TS_ID_STATS_SERIAL, "Serial");
+#endif
+
+#ifdef CONFIG_THINGSET_BLUETOOTH
+STATS_ADD_IFACE(STATS_BLUETOOTH, TS_ID_STATS_BLUETOOTH, "Bluetooth");
+#endif
+
+#ifdef CONFIG_THINGSET_CAN
+STATS_ADD_IFACE(STATS_CAN, TS_ID_STATS_CAN, "CAN");
+#endif
+
+#ifdef CONFIG_THINGSET_WEBSOCKET
+STATS_ADD_IFACE(STATS_WEBSOCKET, TS_ID_STATS_WEBSOCKET, "WebSocket");
+#endif
+
+#if defined(CONFIG_THINGSET_STATS_LATENCY) && defined(CONFIG_THINGSET_SHELL)
+
+static const char *const iface_names[STATS_NUM_IFACES] = {
+    [STATS_SERIAL] = "Serial",
+    [STATS_BLUETOOTH] = "Bluetooth",
+    [STATS_CAN] = "CAN",
+    [STATS_WEBSOCKET] = "WebSocket",
+};
+
+static int cmd_latency(const struct shell *sh, size_t argc, char **argv)
+{
+    for (int i = 0; i < STATS_NUM_IFACES; i++) {
+        bool header_printed = false;
+
+        for (int j = 0; j < NUM_BUCKETS; j++) {
+            uint32_t queued = atomic_get(&queue_delay_hist[i][j]);
+            uint32_t service = atomic_get(&service_time_hist[i][j]);
+
+            if (queued == 0 && service == 0) {
+                continue;
+            }
+
+            if (!header_printed) {
+                shell_print(sh, "%s:", iface_names[i]);
+                shell_print(sh, "  %-21s %10s %10s", "latency (us)", "queueing", "service");
+                header_printed = true;
+            }
+
+            uint32_t lower = (j == 0) ? 0 : BIT(j);
+            if (j < NUM_BUCKETS - 1) {
+                shell_print(sh, "  %9u - %9u %10u %10u", lower, (uint32_t)BIT(j + 1) - 1, queued,
+                            service);
+            }
+            else {
+                shell_print(sh, "  %9u - %9s %10u %10u", lower, "", queued, service);
+            }
+        }
+    }
+
+    return 0;
+}
+
+SHELL_CMD_REGISTER(thingset_latency, NULL, "ThingSet request latency histograms", cmd_latency);
+
+#endif /* CONFIG_THINGSET_STATS_LATENCY && CONFIG_THINGSET_SHELL */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) The ThingSet Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef THINGSET_STATS_H_
+#define THINGSET_STATS_H_
+
+#include <zephyr/kernel.h>
+
+/** Interfaces with separate traffic counters */
+enum stats_iface
+{
+    STATS_SERIAL,
+    STATS_BLUETOOTH,
+    STATS_CAN,
+    STATS_WEBSOCKET,
+    STATS_NUM_IFACES,
+};
+
+/** Counters available for each interface (order matches the IDs in sdk.h) */
+enum stats_counter
+{
+    STATS_REQUESTS,
+    STATS_RESPONSES,
+    STATS_REPORTS,
+    STATS_BYTES_IN,
+    STATS_BYTES_OUT,
+    STATS_RX_DROPPED,
+    STATS_CRC_ERRORS,
+    STATS_TIMEOUTS,
+    STATS_NUM_COUNTERS,
+};
+
+#ifdef CONFIG_THINGSET_STATS
+
+extern atomic_t thingset_stats[STATS_NUM_IFACES][STATS_NUM_COUNTERS];
+
+/**
+ * Add a value to an interface counter. Safe to be called from ISR context.
+ */
+static inline void stats_add(enum stats_iface iface, enum stats_counter counter, size_t value)
+{
+    atomic_add(&thingset_stats[iface][counter], value);
+}
+
+/**
+ * Increment an interface counter. Safe to be called from ISR context.
+ */
+static inline void stats_inc(enum stats_iface iface, enum stats_counter counter)
+{
+    atomic_inc(&thingset_stats[iface][counter]);
+}
+
+#else
+
+static inline void stats_add(enum stats_iface iface, enum stats_counter counter, size_t value)
+{}
+
+static inline void stats_inc(enum stats_iface iface, enum stats_counter counter)
+{}
+
+#endif /* CONFIG_THINGSET_STATS */
+
+#ifdef CONFIG_THINGSET_STATS_LATENCY
+
+/**
+ * Get a timestamp for latency measurements. Safe to be called from ISR context.
+ */
+static inline uint32_t stats_timestamp(void)
+{
+    return k_cycle_get_32();
+}
+
+/**
+ * Record the latency of a request in the histograms of an interface.
+ *
+ * @param iface Interface which received the request
+ * @param t_arrival Timestamp when the request was received completely
+ * @param t_start Timestamp when the processing of the request started
+ * @param t_done Timestamp when the response was sent
+ */
+void stats_record_latency(enum stats_iface iface, uint32_t t_arrival, uint32_t t_start,
+                          uint32_t t_done);
+
+#else
+
+static inline uint32_t stats_timestamp(void)
+{
+    return 0;
+}
+
+static inline void stats_record_latency(enum stats_iface iface, uint32_t t_arrival,
+                                        uint32_t t_start, uint32_t t_done)
+{}
+
+#endif /* CONFIG_THINGSET_STATS_LATENCY */
+
+#endif /* THINGSET_STATS_H_ */
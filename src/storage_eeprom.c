@@ -60,9 +60,8 @@ static int thingset_eeprom_load(off_t offset)
         return -EINVAL;
     }
 
-    struct shared_buffer *sbuf = thingset_sdk_shared_buffer();
-
-    k_sem_take(&sbuf->lock, K_FOREVER);
+    struct shared_buffer *sbuf =
+        thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SHARED_TX_BUF_SIZE, K_FOREVER);
 
     if (header.data_len > sbuf->size) {
 #ifdef CONFIG_THINGSET_STORAGE_EEPROM_PROGRESSIVE_IMPORT_EXPORT
@@ -154,7 +153,7 @@ static int thingset_eeprom_load(off_t offset)
     }
 
 out:
-    k_sem_give(&sbuf->lock);
+    thingset_sdk_tx_buf_release(sbuf);
 
     return err;
 }
@@ -163,8 +162,8 @@ static int thingset_eeprom_save(off_t offset, size_t useable_size)
 {
     int err = 0;
 
-    struct shared_buffer *sbuf = thingset_sdk_shared_buffer();
-    k_sem_take(&sbuf->lock, K_FOREVER);
+    struct shared_buffer *sbuf =
+        thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SHARED_TX_BUF_SIZE, K_FOREVER);
 
     struct thingset_eeprom_header header = { .version = CONFIG_THINGSET_STORAGE_DATA_VERSION };
 
@@ -277,7 +276,7 @@ static int thingset_eeprom_save(off_t offset, size_t useable_size)
     }
 #endif /* CONFIG_THINGSET_STORAGE_EEPROM_PROGRESSIVE_IMPORT_EXPORT */
 out:
-    k_sem_give(&sbuf->lock);
+    thingset_sdk_tx_buf_release(sbuf);
 
     return err;
 }
@@ -77,8 +77,8 @@ int thingset_storage_load()
         }
     }
 
-    struct shared_buffer *sbuf = thingset_sdk_shared_buffer();
-    k_sem_take(&sbuf->lock, K_FOREVER);
+    struct shared_buffer *sbuf =
+        thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SHARED_TX_BUF_SIZE, K_FOREVER);
 
     int num_bytes = nvs_read(&fs, THINGSET_DATA_ID, sbuf->data, sbuf->size);
     if (num_bytes < 0) {
@@ -108,7 +108,7 @@ int thingset_storage_load()
     }
 
 out:
-    k_sem_give(&sbuf->lock);
+    thingset_sdk_tx_buf_release(sbuf);
 
     return err;
 }
@@ -124,8 +124,8 @@ int thingset_storage_save()
         }
     }
 
-    struct shared_buffer *sbuf = thingset_sdk_shared_buffer();
-    k_sem_take(&sbuf->lock, K_FOREVER);
+    struct shared_buffer *sbuf =
+        thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SHARED_TX_BUF_SIZE, K_FOREVER);
 
     *((uint16_t *)&sbuf->data[0]) = (uint16_t)CONFIG_THINGSET_STORAGE_DATA_VERSION;
 
@@ -153,7 +153,7 @@ int thingset_storage_save()
         err = -EINVAL;
     }
 
-    k_sem_give(&sbuf->lock);
+    thingset_sdk_tx_buf_release(sbuf);
 
     return err;
 }
@@ -20,6 +20,8 @@
 #include <signal.h>
 #include <stdio.h>
 
+#include "stats.h"
+
 LOG_MODULE_REGISTER(thingset_websocket, CONFIG_THINGSET_SDK_LOG_LEVEL);
 
 #define CA_CERTIFICATE_TAG 1
@@ -38,10 +40,6 @@ static char server_path[23]; /* "/node/" + pNodeID (16 bytes) + '\0' */
 
 static int websock = -1;
 
-#ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-static struct k_work_delayable reporting_work;
-#endif
-
 THINGSET_ADD_ITEM_STRING(TS_ID_NET, TS_ID_NET_WEBSOCKET_HOST, "sWebsocketHost", server_host,
                          sizeof(server_host), THINGSET_ANY_RW, TS_SUBSET_NVM);
 
@@ -181,44 +179,86 @@ int thingset_websocket_send(const uint8_t *buf, size_t len)
     }
 
     int bytes_sent = websocket_send_msg(websock, buf, len, WEBSOCKET_OPCODE_DATA_TEXT, true, true,
-                                        SYS_FOREVER_MS);
+                                        CONFIG_THINGSET_WEBSOCKET_TX_TIMEOUT_MS);
 
     if (bytes_sent < 0) {
         LOG_ERR("Failed to send data via WebSocket: %d", bytes_sent);
+        if (bytes_sent == -ETIMEDOUT || bytes_sent == -EAGAIN) {
+            stats_inc(STATS_WEBSOCKET, STATS_TIMEOUTS);
+        }
+        return bytes_sent;
     }
 
+    stats_add(STATS_WEBSOCKET, STATS_BYTES_OUT, bytes_sent);
+
     return 0;
 }
 
 int thingset_websocket_send_report(const char *path)
 {
-    struct shared_buffer *tx_buf = thingset_sdk_shared_buffer();
-    k_sem_take(&tx_buf->lock, K_FOREVER);
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire_policy(
+        CONFIG_THINGSET_SHARED_TX_BUF_SIZE, THINGSET_SDK_TX_BUF_WAIT,
+        K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+    if (tx_buf == NULL) {
+        return -EBUSY;
+    }
 
     int len =
         thingset_report_path(&ts, tx_buf->data, tx_buf->size, path, THINGSET_TXT_NAMES_VALUES);
 
-    int ret = thingset_websocket_send(tx_buf->data, len);
+    int ret = len > 0 ? thingset_websocket_send(tx_buf->data, len) : len;
+    if (ret == 0) {
+        stats_inc(STATS_WEBSOCKET, STATS_REPORTS);
+    }
+
+    thingset_sdk_tx_buf_release(tx_buf);
+    return ret;
+}
+
+int thingset_websocket_send_report_handle(const struct thingset_report_handle *handle)
+{
+    struct shared_buffer *tx_buf = thingset_sdk_tx_buf_acquire_policy(
+        CONFIG_THINGSET_SHARED_TX_BUF_SIZE, THINGSET_SDK_TX_BUF_WAIT,
+        K_MSEC(CONFIG_THINGSET_SDK_TX_BUF_REPORT_TIMEOUT_MS));
+    if (tx_buf == NULL) {
+        return -EBUSY;
+    }
+
+    int len = thingset_sdk_report_by_handle(handle, tx_buf->data, tx_buf->size,
+                                            THINGSET_TXT_NAMES_VALUES);
 
-    k_sem_give(&tx_buf->lock);
+    int ret = len > 0 ? thingset_websocket_send(tx_buf->data, len) : len;
+    if (ret == 0) {
+        stats_inc(STATS_WEBSOCKET, STATS_REPORTS);
+    }
+
+    thingset_sdk_tx_buf_release(tx_buf);
     return ret;
 }
 
 #ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
 
-static void websocket_regular_report_handler(struct k_work *work)
+static int websocket_report_sink_send(struct thingset_report_sink *sink, const uint8_t *buf,
+                                      size_t len)
 {
-    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-    static int64_t pub_time;
+    if (websock < 0) {
+        /* not connected, so nothing was lost */
+        return 0;
+    }
 
-    if (live_reporting_enable && websock >= 0) {
-        thingset_websocket_send_report(TS_NAME_SUBSET_LIVE);
+    int ret = thingset_websocket_send(buf, len);
+    if (ret == 0) {
+        stats_inc(STATS_WEBSOCKET, STATS_REPORTS);
     }
 
-    pub_time += live_reporting_period;
-    thingset_sdk_reschedule_work(dwork, K_TIMEOUT_ABS_MS(pub_time));
+    return ret;
 }
 
+static struct thingset_report_sink report_sink = {
+    .format = THINGSET_TXT_NAMES_VALUES,
+    .send = websocket_report_sink_send,
+};
+
 #endif
 
 /* disabled because struct sigaction is not found when compiled for Zephyr v3.6 */
@@ -255,8 +295,7 @@ static void websocket_thread(void)
 #endif
 
 #ifdef CONFIG_THINGSET_SUBSET_LIVE_METRICS
-    k_work_init_delayable(&reporting_work, websocket_regular_report_handler);
-    thingset_sdk_reschedule_work(&reporting_work, K_NO_WAIT);
+    thingset_sdk_register_report_sink(&report_sink);
 #endif
 
     if (IS_ENABLED(CONFIG_NET_SOCKETS_SOCKOPT_TLS)) {
@@ -311,17 +350,25 @@ static void websocket_thread(void)
                 break;
             }
 
-            struct shared_buffer *tx_buf = thingset_sdk_shared_buffer();
-            k_sem_take(&tx_buf->lock, K_FOREVER);
+            uint32_t t_arrival = stats_timestamp();
+            stats_inc(STATS_WEBSOCKET, STATS_REQUESTS);
+            stats_add(STATS_WEBSOCKET, STATS_BYTES_IN, bytes_received);
+
+            struct shared_buffer *tx_buf =
+                thingset_sdk_tx_buf_acquire(CONFIG_THINGSET_SHARED_TX_BUF_SIZE, K_FOREVER);
+            uint32_t t_start = stats_timestamp();
 
-            int len = thingset_process_message(&ts, (uint8_t *)rx_buf, bytes_received, tx_buf->data,
-                                               tx_buf->size);
+            int len = thingset_sdk_process_message((uint8_t *)rx_buf, bytes_received,
+                                                   tx_buf->data, tx_buf->size);
             if (len > 0) {
                 LOG_DBG("Sending response with %d bytes", len);
                 thingset_websocket_send(tx_buf->data, len);
+                stats_inc(STATS_WEBSOCKET, STATS_RESPONSES);
             }
 
-            k_sem_give(&tx_buf->lock);
+            stats_record_latency(STATS_WEBSOCKET, t_arrival, t_start, stats_timestamp());
+
+            thingset_sdk_tx_buf_release(tx_buf);
         }
     }
 }
@@ -83,7 +83,8 @@ static void wifi_mgmt_event_handler(struct net_mgmt_event_callback *cb, uint32_t
         case NET_EVENT_WIFI_DISCONNECT_RESULT:
             ipv4_addr[0] = '\0';
             LOG_INF("WiFi disconnected, trying to reconnect in 60s");
-            thingset_sdk_reschedule_work(&wifi_connect_work, K_SECONDS(60));
+            thingset_sdk_reschedule_work_prio(&wifi_connect_work, K_SECONDS(60),
+                                              THINGSET_SDK_PRIO_BACKGROUND);
             break;
         default:
             break;
@@ -105,7 +106,8 @@ static int wifi_init(void)
     net_mgmt_add_event_callback(&wifi_mgmt_cb);
 
     /* attempt to connect after a short delay */
-    thingset_sdk_reschedule_work(&wifi_connect_work, K_SECONDS(3));
+    thingset_sdk_reschedule_work_prio(&wifi_connect_work, K_SECONDS(3),
+                                      THINGSET_SDK_PRIO_BACKGROUND);
 
     return 0;
 }
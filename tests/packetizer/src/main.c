@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) The ThingSet Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/ztest.h>
+
+#include "packetizer.h"
+
+#ifdef CONFIG_ARCH_POSIX
+#include "native_rtc.h"
+#endif
+
+#define PAYLOAD_SIZE 1024
+#define CHUNK_SIZE   244 /* max. notification size with 247 bytes ATT MTU */
+
+#define BENCH_ITERATIONS 2000
+
+static uint8_t payload[PAYLOAD_SIZE];
+static uint8_t chunk[CHUNK_SIZE + 1];
+static uint8_t reassembled[PAYLOAD_SIZE];
+
+static uint32_t rand_state = 1;
+
+/* simple deterministic pseudo-random numbers, so that failures are reproducible */
+static uint32_t rand_next(void)
+{
+    rand_state = rand_state * 1103515245 + 12345;
+    return rand_state >> 8;
+}
+
+/*
+ * Timestamp in microseconds, only suitable to calculate differences. On native_sim, the host
+ * clock is used, as the simulated time does not advance while the CPU is busy.
+ */
+static uint32_t timestamp_us(void)
+{
+#ifdef CONFIG_ARCH_POSIX
+    return (uint32_t)native_rtc_gettime_us(RTC_CLOCK_REAL);
+#else
+    return k_cyc_to_us_floor32(k_cycle_get_32());
+#endif
+}
+
+/* byte-wise implementation as used before the word-at-a-time fast path (reference) */
+static int packetize_bytewise(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len,
+                              int *src_pos)
+{
+    int pos_buf = *src_pos;
+    int pos_chunk = 0;
+    if (pos_buf == 0) {
+        dst[pos_chunk++] = MSG_END;
+    }
+
+    while (pos_chunk < dst_len && pos_buf < src_len) {
+        if (src[pos_buf] == MSG_END) {
+            dst[pos_chunk++] = MSG_ESC;
+            dst[pos_chunk++] = MSG_ESC_END;
+        }
+        else if (src[pos_buf] == MSG_SKIP) {
+            dst[pos_chunk++] = MSG_ESC;
+            dst[pos_chunk++] = MSG_ESC_SKIP;
+        }
+        else if (src[pos_buf] == MSG_ESC) {
+            dst[pos_chunk++] = MSG_ESC;
+            dst[pos_chunk++] = MSG_ESC_ESC;
+        }
+        else {
+            dst[pos_chunk++] = src[pos_buf];
+        }
+        pos_buf++;
+    }
+    if (pos_chunk < dst_len - 1 && pos_buf == src_len) {
+        dst[pos_chunk++] = MSG_END;
+        pos_buf++;
+    }
+
+    (*src_pos) = pos_buf;
+    return pos_chunk;
+}
+
+/* text mode report with typical ThingSet names and values */
+static void fill_text_payload(void)
+{
+    size_t pos = 0;
+
+    while (pos < PAYLOAD_SIZE) {
+        char item[32];
+        int len = snprintf(item, sizeof(item), "\"rItem%u_degC\":%u.%u,", rand_next() % 100,
+                           rand_next() % 100, rand_next() % 10);
+        len = MIN(len, PAYLOAD_SIZE - pos);
+        memcpy(payload + pos, item, len);
+        pos += len;
+    }
+}
+
+/* binary mode report with data object IDs and float32 values */
+static void fill_cbor_payload(void)
+{
+    size_t pos = 0;
+
+    while (pos + 8 <= PAYLOAD_SIZE) {
+        float value = (float)(rand_next() % 100000) / 100.0F;
+        uint32_t raw;
+
+        payload[pos++] = 0x19;
+        sys_put_be16(0x200 + rand_next() % 0x100, &payload[pos]);
+        pos += 2;
+        payload[pos++] = 0xFA;
+        memcpy(&raw, &value, sizeof(raw));
+        sys_put_be32(raw, &payload[pos]);
+        pos += 4;
+    }
+    memset(payload + pos, 0, PAYLOAD_SIZE - pos);
+}
+
+/* random data with the given share of special bytes in percent */
+static void fill_random_payload(int special_percent)
+{
+    static const uint8_t special[] = { MSG_END, MSG_SKIP, MSG_ESC, MSG_ESC_END, MSG_ESC_ESC };
+
+    for (size_t i = 0; i < PAYLOAD_SIZE; i++) {
+        if (rand_next() % 100 < special_percent) {
+            payload[i] = special[rand_next() % ARRAY_SIZE(special)];
+        }
+        else {
+            payload[i] = rand_next();
+        }
+    }
+}
+
+/* packetize the payload with both implementations and reassemble it again */
+static void check_payload(size_t len, size_t chunk_size)
+{
+    uint8_t chunk_ref[CHUNK_SIZE + 1];
+    int pos = 0;
+    int pos_ref = 0;
+    int pos_reassembled = 0;
+    bool escape = false;
+    bool finished = false;
+    int chunk_len;
+
+    do {
+        chunk_len = packetize(payload, len, chunk, chunk_size, &pos);
+        int chunk_len_ref = packetize_bytewise(payload, len, chunk_ref, chunk_size, &pos_ref);
+
+        zassert_equal(chunk_len, chunk_len_ref, "chunk length differs");
+        zassert_equal(pos, pos_ref, "source position differs");
+        zassert_mem_equal(chunk, chunk_ref, chunk_len);
+
+        if (chunk_len > 0) {
+            zassert_false(finished, "message finished before last chunk");
+            finished = reassemble(chunk, chunk_len, reassembled, sizeof(reassembled),
+                                  &pos_reassembled, &escape);
+        }
+    } while (chunk_len > 0);
+
+    zassert_true(finished, "message not finished");
+    zassert_equal(pos_reassembled, len);
+    zassert_mem_equal(reassembled, payload, len);
+}
+
+ZTEST(thingset_packetizer, test_escape_sequences)
+{
+    const uint8_t src[] = { 0x01, MSG_END, MSG_SKIP, MSG_ESC, 0x02 };
+    const uint8_t exp[] = {
+        MSG_END, 0x01, MSG_ESC, MSG_ESC_END, MSG_ESC, MSG_ESC_SKIP, MSG_ESC, MSG_ESC_ESC,
+        0x02,    MSG_END,
+    };
+    int pos = 0;
+
+    int len = packetize(src, sizeof(src), chunk, CHUNK_SIZE, &pos);
+    zassert_equal(len, sizeof(exp));
+    zassert_mem_equal(chunk, exp, sizeof(exp));
+
+    len = packetize(src, sizeof(src), chunk, CHUNK_SIZE, &pos);
+    zassert_equal(len, 0);
+}
+
+ZTEST(thingset_packetizer, test_roundtrip)
+{
+    static const int special_percent[] = { 0, 1, 10, 50, 100 };
+
+    for (int i = 0; i < ARRAY_SIZE(special_percent); i++) {
+        fill_random_payload(special_percent[i]);
+        for (int j = 0; j < 50; j++) {
+            /* odd lengths and chunk sizes to hit all word alignments */
+            check_payload(rand_next() % PAYLOAD_SIZE, 3 + rand_next() % (CHUNK_SIZE - 3));
+        }
+    }
+
+    fill_text_payload();
+    check_payload(PAYLOAD_SIZE, CHUNK_SIZE);
+
+    fill_cbor_payload();
+    check_payload(PAYLOAD_SIZE, CHUNK_SIZE);
+}
+
+/* concatenated segments must match the frame created by packetize in a single chunk */
+static void check_segments(size_t len, size_t num_segs, size_t max_len)
+{
+    static uint8_t frame[2 * PAYLOAD_SIZE + 2];
+    static uint8_t gathered[2 * PAYLOAD_SIZE + 2];
+    struct packet_segment segs[8];
+    size_t gathered_len = 0;
+    int pos = 0;
+
+    int frame_len = packetize(payload, len, frame, sizeof(frame), &pos);
+
+    pos = 0;
+    while (pos <= len) {
+        int num = packetize_segments(payload, len, segs, num_segs, max_len, &pos);
+        size_t total = 0;
+
+        for (int i = 0; i < num; i++) {
+            zassert_true(segs[i].len > 0);
+            if (segs[i].len > 2) {
+                /* data is referenced instead of copied */
+                zassert_true(segs[i].data >= payload
+                             && segs[i].data + segs[i].len <= payload + len);
+            }
+            memcpy(gathered + gathered_len, segs[i].data, segs[i].len);
+            gathered_len += segs[i].len;
+            total += segs[i].len;
+        }
+        zassert_true(total <= max_len, "segments exceed max. length");
+    }
+
+    zassert_equal(gathered_len, frame_len);
+    zassert_mem_equal(gathered, frame, frame_len);
+}
+
+ZTEST(thingset_packetizer, test_segments)
+{
+    static const int special_percent[] = { 0, 1, 10, 50, 100 };
+
+    for (int i = 0; i < ARRAY_SIZE(special_percent); i++) {
+        fill_random_payload(special_percent[i]);
+        for (int j = 0; j < 50; j++) {
+            check_segments(rand_next() % PAYLOAD_SIZE, 2 + rand_next() % 7,
+                           3 + rand_next() % (CHUNK_SIZE - 3));
+        }
+    }
+}
+
+static uint32_t bench_packetize(int (*fn)(const uint8_t *, size_t, uint8_t *, size_t, int *))
+{
+    uint32_t t_start = timestamp_us();
+
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        int pos = 0;
+        while (fn(payload, PAYLOAD_SIZE, chunk, CHUNK_SIZE, &pos) != 0) {
+            /* only the encoding is measured */
+        }
+    }
+
+    return MAX(timestamp_us() - t_start, 1);
+}
+
+static void bench_payload(const char *name)
+{
+    uint32_t t_bytewise = bench_packetize(packetize_bytewise);
+    uint32_t t_swar = bench_packetize(packetize);
+
+    uint64_t bytes = (uint64_t)BENCH_ITERATIONS * PAYLOAD_SIZE;
+
+    TC_PRINT("{\"benchmark\":\"packetize\",\"payload\":\"%s\",\"bytes\":%u,"
+             "\"bytewise_kb_per_s\":%u,\"swar_kb_per_s\":%u,\"speedup_x100\":%u}\n",
+             name, (uint32_t)bytes, (uint32_t)(bytes * USEC_PER_SEC / 1024 / t_bytewise),
+             (uint32_t)(bytes * USEC_PER_SEC / 1024 / t_swar),
+             (uint32_t)((uint64_t)t_bytewise * 100 / t_swar));
+}
+
+ZTEST(thingset_packetizer, test_benchmark)
+{
+    fill_text_payload();
+    bench_payload("text");
+
+    fill_cbor_payload();
+    bench_payload("cbor");
+}
+
+ZTEST_SUITE(thingset_packetizer, NULL, NULL, NULL, NULL, NULL);
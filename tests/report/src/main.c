@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) The ThingSet Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/ztest.h>
+
+#include <thingset.h>
+#include <thingset/sdk.h>
+
+#include "report_on_change.h"
+
+#define NUM_LIVE_ITEMS 3
+
+#define TEST_REPORT_TIMEOUT K_SECONDS(2)
+
+/* settings of the live reporting in sdk.c */
+extern bool live_reporting_enable;
+extern uint32_t live_reporting_period;
+extern bool live_reporting_on_change;
+extern uint32_t live_reporting_keyframe_interval;
+
+static uint8_t buf_handle[512];
+static uint8_t buf_path[512];
+
+/* test data objects */
+static float test_float = 1234.56;
+static int32_t test_int = -42;
+static bool test_bool = true;
+static char test_string[] = "Hello World!";
+static float nested_float = 3.5;
+
+static void test_fn(void)
+{}
+
+THINGSET_ADD_GROUP(TS_ID_ROOT, 0x200, "Test", THINGSET_NO_CALLBACK);
+THINGSET_ADD_ITEM_FLOAT(0x200, 0x201, "rFloat", &test_float, 1, THINGSET_ANY_R, TS_SUBSET_LIVE);
+THINGSET_ADD_ITEM_INT32(0x200, 0x202, "rInt", &test_int, THINGSET_ANY_R, TS_SUBSET_LIVE);
+THINGSET_ADD_ITEM_BOOL(0x200, 0x203, "wBool", &test_bool, THINGSET_ANY_RW, 0);
+THINGSET_ADD_ITEM_STRING(0x200, 0x204, "cString", test_string, sizeof(test_string),
+                         THINGSET_ANY_R, TS_SUBSET_LIVE);
+
+/* group with children which are no plain items */
+THINGSET_ADD_GROUP(0x200, 0x210, "Nested", THINGSET_NO_CALLBACK);
+THINGSET_ADD_ITEM_FLOAT(0x210, 0x211, "rNestedFloat", &nested_float, 1, THINGSET_ANY_R, 0);
+THINGSET_ADD_FN_VOID(0x200, 0x220, "xFunction", &test_fn, THINGSET_ANY_RW);
+
+static const enum thingset_data_format formats[] = {
+    THINGSET_TXT_NAMES_VALUES,
+    THINGSET_BIN_IDS_VALUES,
+    THINGSET_BIN_NAMES_VALUES,
+};
+
+/* the report generated via a handle must be identical to the one generated via its path */
+static void check_report(const char *path, uint16_t id)
+{
+    struct thingset_report_handle handle_path;
+    struct thingset_report_handle handle_id;
+
+    zassert_ok(thingset_sdk_report_handle_init(&handle_path, path));
+    zassert_ok(thingset_sdk_report_handle_init_by_id(&handle_id, id));
+
+    for (int i = 0; i < ARRAY_SIZE(formats); i++) {
+        int len_path =
+            thingset_report_path(&ts, (char *)buf_path, sizeof(buf_path), path, formats[i]);
+        zassert_true(len_path > 0, "%s: report via path failed (format %d)", path, formats[i]);
+
+        int len = thingset_sdk_report_by_handle(&handle_path, buf_handle, sizeof(buf_handle),
+                                                formats[i]);
+        zassert_equal(len, len_path, "%s: length %d instead of %d (format %d)", path, len,
+                      len_path, formats[i]);
+        zassert_mem_equal(buf_handle, buf_path, len_path, "%s: wrong report (format %d)", path,
+                          formats[i]);
+
+        len = thingset_sdk_report_by_handle(&handle_id, buf_handle, sizeof(buf_handle),
+                                            formats[i]);
+        zassert_equal(len, len_path, "0x%X: length %d instead of %d (format %d)", id, len,
+                      len_path, formats[i]);
+        zassert_mem_equal(buf_handle, buf_path, len_path, "0x%X: wrong report (format %d)", id,
+                          formats[i]);
+    }
+}
+
+ZTEST(thingset_report, test_report_item)
+{
+    check_report("Test/rFloat", 0x201);
+    check_report("Test/cString", 0x204);
+    check_report("Test/Nested/rNestedFloat", 0x211);
+}
+
+ZTEST(thingset_report, test_report_group)
+{
+    check_report("Test", 0x200);
+    check_report("Test/Nested", 0x210);
+}
+
+ZTEST(thingset_report, test_report_subset)
+{
+    check_report(TS_NAME_SUBSET_LIVE, TS_ID_SUBSET_LIVE);
+}
+
+ZTEST(thingset_report, test_report_buffer_too_small)
+{
+    struct thingset_report_handle handle;
+
+    zassert_ok(thingset_sdk_report_handle_init_by_id(&handle, 0x201));
+
+    for (int i = 0; i < ARRAY_SIZE(formats); i++) {
+        for (size_t size = 0; size < 4; size++) {
+            memset(buf_handle, 0xAA, sizeof(buf_handle));
+            int len = thingset_sdk_report_by_handle(&handle, buf_handle, size, formats[i]);
+            zassert_true(len < 0, "report fits into %zu bytes", size);
+            zassert_equal(buf_handle[size], 0xAA, "buffer overflow with size %zu", size);
+        }
+    }
+}
+
+ZTEST_SUITE(thingset_report, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(thingset_report_on_change, test_keyframe)
+{
+    zassert_equal(report_on_change_update(false), 0);
+    zassert_equal(report_on_change_update(true), NUM_LIVE_ITEMS);
+}
+
+ZTEST(thingset_report_on_change, test_abs_deadband)
+{
+    zassert_ok(thingset_sdk_report_set_deadband(0x201, 1.0F, 0.0F));
+
+    test_float += 0.5F;
+    zassert_equal(report_on_change_update(false), 0);
+
+    /* the reference value is only updated if the change was reported */
+    test_float += 0.75F;
+    zassert_equal(report_on_change_update(false), 1);
+    zassert_equal(report_on_change_update(false), 0);
+}
+
+ZTEST(thingset_report_on_change, test_rel_deadband)
+{
+    /* negative integer (-42) to cover decoding of CBOR negative integers */
+    zassert_ok(thingset_sdk_report_set_deadband(0x202, 0.0F, 0.1F));
+
+    test_int -= 3;
+    zassert_equal(report_on_change_update(false), 0);
+
+    test_int -= 2;
+    zassert_equal(report_on_change_update(false), 1);
+}
+
+ZTEST(thingset_report_on_change, test_smaller_deadband_applies)
+{
+    /* 0.1% of 1234.56 is the smaller threshold */
+    zassert_ok(thingset_sdk_report_set_deadband(0x201, 100.0F, 0.001F));
+
+    test_float += 1.0F;
+    zassert_equal(report_on_change_update(false), 0);
+
+    test_float += 1.0F;
+    zassert_equal(report_on_change_update(false), 1);
+}
+
+ZTEST(thingset_report_on_change, test_no_deadband)
+{
+    test_float += 0.5F;
+    zassert_equal(report_on_change_update(false), 1);
+
+    test_int++;
+    zassert_equal(report_on_change_update(false), 1);
+}
+
+ZTEST(thingset_report_on_change, test_non_numeric)
+{
+    test_string[0] = 'h';
+    zassert_equal(report_on_change_update(false), 1);
+    zassert_equal(report_on_change_update(false), 0);
+}
+
+ZTEST(thingset_report_on_change, test_untracked_item)
+{
+    zassert_equal(thingset_sdk_report_set_deadband(0x203, 1.0F, 0.0F), -ENOENT);
+}
+
+/* delta report with rFloat as the only changed item */
+static int encode_delta(enum thingset_data_format format)
+{
+    test_float += 10.0F;
+    zassert_equal(report_on_change_update(false), 1);
+
+    int len = report_on_change_encode(buf_handle, sizeof(buf_handle), format);
+    zassert_true(len > 0, "encoding failed: %d", len);
+
+    return len;
+}
+
+ZTEST(thingset_report_on_change, test_delta_txt)
+{
+    const struct thingset_data_object *obj = thingset_get_object_by_id(&ts, 0x201);
+    char *exp = (char *)buf_path;
+
+    int len = encode_delta(THINGSET_TXT_NAMES_VALUES);
+
+    int pos = snprintf(exp, sizeof(buf_path), "#%s {\"Test/rFloat\":", TS_NAME_SUBSET_LIVE);
+    pos += thingset_export_item(&ts, buf_path + pos, sizeof(buf_path) - pos, obj,
+                                THINGSET_TXT_NAMES_VALUES);
+    exp[pos++] = '}';
+    exp[pos] = '\0';
+
+    zassert_equal(len, pos, "wrong length of %.*s", len, (char *)buf_handle);
+    zassert_mem_equal(buf_handle, exp, pos);
+}
+
+ZTEST(thingset_report_on_change, test_delta_bin_ids)
+{
+    const struct thingset_data_object *obj = thingset_get_object_by_id(&ts, 0x201);
+    const uint8_t header[] = { 0x1F, 0x18, TS_ID_SUBSET_LIVE, 0xA1, 0x19, 0x02, 0x01 };
+
+    int len = encode_delta(THINGSET_BIN_IDS_VALUES);
+
+    memcpy(buf_path, header, sizeof(header));
+    int pos = sizeof(header);
+    pos += thingset_export_item(&ts, buf_path + pos, sizeof(buf_path) - pos, obj,
+                                THINGSET_BIN_VALUES_ONLY);
+
+    zassert_equal(len, pos);
+    zassert_mem_equal(buf_handle, buf_path, pos);
+}
+
+ZTEST(thingset_report_on_change, test_delta_bin_names)
+{
+    const struct thingset_data_object *obj = thingset_get_object_by_id(&ts, 0x201);
+    const uint8_t header[] = { 0x1F, 0x65, 'm', 'L', 'i', 'v', 'e', 0xA1, 0x6B, 'T', 'e',
+                               's',  't',  '/', 'r', 'F', 'l', 'o', 'a', 't' };
+
+    int len = encode_delta(THINGSET_BIN_NAMES_VALUES);
+
+    memcpy(buf_path, header, sizeof(header));
+    int pos = sizeof(header);
+    pos += thingset_export_item(&ts, buf_path + pos, sizeof(buf_path) - pos, obj,
+                                THINGSET_BIN_VALUES_ONLY);
+
+    zassert_equal(len, pos);
+    zassert_mem_equal(buf_handle, buf_path, pos);
+}
+
+static void on_change_before(void *fixture)
+{
+    test_float = 1234.56F;
+    test_int = -42;
+    test_string[0] = 'H';
+
+    thingset_sdk_report_set_deadband(0x201, 0.0F, 0.0F);
+    thingset_sdk_report_set_deadband(0x202, 0.0F, 0.0F);
+
+    /* store current values as reference */
+    report_on_change_update(true);
+}
+
+ZTEST_SUITE(thingset_report_on_change, NULL, NULL, on_change_before, NULL, NULL);
+
+static K_SEM_DEFINE(sink_sem, 0, 1);
+static int sink_err;
+static bool sink_full_report;
+
+static int test_sink_send(struct thingset_report_sink *sink, const uint8_t *buf, size_t len)
+{
+    static char report[sizeof(buf_handle)];
+
+    /* full reports contain all items, delta reports only the changed rFloat */
+    snprintf(report, sizeof(report), "%.*s", (int)len, buf);
+    sink_full_report = strstr(report, "rInt") != NULL;
+    k_sem_give(&sink_sem);
+
+    return sink_err;
+}
+
+static struct thingset_report_sink test_sink = {
+    .format = THINGSET_TXT_NAMES_VALUES,
+    .send = test_sink_send,
+};
+
+ZTEST(thingset_report_sink, test_keyframe_after_failed_delta)
+{
+    /* only the first report after enabling is a keyframe */
+    live_reporting_keyframe_interval = 0;
+    live_reporting_period = 100;
+    live_reporting_on_change = true;
+    live_reporting_enable = true;
+
+    zassert_ok(k_sem_take(&sink_sem, TEST_REPORT_TIMEOUT));
+    zassert_true(sink_full_report, "first report is not a keyframe");
+
+    /* delta report gets lost */
+    sink_err = -EBUSY;
+    test_float += 10.0F;
+    zassert_ok(k_sem_take(&sink_sem, TEST_REPORT_TIMEOUT));
+    zassert_false(sink_full_report, "delta report expected");
+
+    /* the lost change is sent with a keyframe, even though nothing changed since */
+    sink_err = 0;
+    zassert_ok(k_sem_take(&sink_sem, TEST_REPORT_TIMEOUT));
+    zassert_true(sink_full_report, "no keyframe after failed delta report");
+
+    /* back to delta reports */
+    test_float += 10.0F;
+    zassert_ok(k_sem_take(&sink_sem, TEST_REPORT_TIMEOUT));
+    zassert_false(sink_full_report, "delta report expected");
+}
+
+static void *report_sink_setup(void)
+{
+    thingset_sdk_register_report_sink(&test_sink);
+
+    return NULL;
+}
+
+static void report_sink_after(void *fixture)
+{
+    live_reporting_enable = false;
+    live_reporting_on_change = false;
+}
+
+ZTEST_SUITE(thingset_report_sink, NULL, report_sink_setup, NULL, report_sink_after, NULL);
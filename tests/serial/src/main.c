@@ -0,0 +1,663 @@
+/*
+ * Copyright (c) The ThingSet Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/ztest.h>
+
+#include <thingset.h>
+#include <thingset/sdk.h>
+#include <thingset/serial.h>
+
+#ifdef CONFIG_ARCH_POSIX
+#include "native_rtc.h"
+#endif
+
+#define TEST_RECEIVE_TIMEOUT K_MSEC(100)
+
+#define BENCH_NUM_REQUESTS 2000
+#define BENCH_NUM_REPORTS  1000
+
+#if defined(CONFIG_THINGSET_SERIAL_RX_ASYNC)
+#define RX_MODE "async"
+#elif defined(CONFIG_THINGSET_SERIAL_RX_INTERRUPT)
+#define RX_MODE "interrupt"
+#else
+#define RX_MODE "polling"
+#endif
+
+static const struct device *uart_dev = DEVICE_DT_GET(DT_CHOSEN(thingset_serial));
+
+static K_SEM_DEFINE(tx_data_sem, 0, 1);
+
+static uint8_t rsp_buf[1024];
+
+static uint32_t latencies_us[BENCH_NUM_REQUESTS];
+
+/* test data objects */
+static float test_float = 1234.56;
+static char test_string[] = "Hello World!";
+
+THINGSET_ADD_GROUP(THINGSET_ID_ROOT, 0x200, "Test", THINGSET_NO_CALLBACK);
+THINGSET_ADD_ITEM_FLOAT(0x200, 0x201, "wFloat", &test_float, 1, THINGSET_ANY_RW, TS_SUBSET_LIVE);
+THINGSET_ADD_ITEM_STRING(0x200, 0x202, "wString", test_string, sizeof(test_string), THINGSET_ANY_RW,
+                         TS_SUBSET_LIVE);
+
+/* long items, so that the live subset spans several report stream chunks */
+static char stream_text[] = "The quick brown fox jumps over the lazy dog, again and again.";
+
+THINGSET_ADD_GROUP(THINGSET_ID_ROOT, 0x210, "Stream", THINGSET_NO_CALLBACK);
+THINGSET_ADD_ITEM_STRING(0x210, 0x211, "rText1", stream_text, sizeof(stream_text), THINGSET_ANY_R,
+                         TS_SUBSET_LIVE);
+THINGSET_ADD_ITEM_STRING(0x210, 0x212, "rText2", stream_text, sizeof(stream_text), THINGSET_ANY_R,
+                         TS_SUBSET_LIVE);
+THINGSET_ADD_ITEM_STRING(0x210, 0x213, "rText3", stream_text, sizeof(stream_text), THINGSET_ANY_R,
+                         TS_SUBSET_LIVE);
+THINGSET_ADD_ITEM_STRING(0x210, 0x214, "rText4", stream_text, sizeof(stream_text), THINGSET_ANY_R,
+                         TS_SUBSET_LIVE);
+
+/* ID and value contain bytes which have to be escaped in binary frames */
+static uint32_t escaped_value = 0xCE0D0A;
+
+THINGSET_ADD_GROUP(THINGSET_ID_ROOT, 0x220, "Binary", THINGSET_NO_CALLBACK);
+THINGSET_ADD_ITEM_UINT32(0x220, 0x20A, "wEscaped", &escaped_value, THINGSET_ANY_RW, 0);
+
+static const char interfering_msg[] = "#Test/wFloat 1.0";
+
+static void interfering_work_handler(struct k_work *work)
+{
+    thingset_serial_send((const uint8_t *)interfering_msg, strlen(interfering_msg));
+}
+
+static K_WORK_DEFINE(interfering_work, interfering_work_handler);
+static atomic_t interfering_armed;
+
+/*
+ * Timestamp in microseconds, only suitable to calculate differences. On native_sim, the host
+ * clock is used, as the simulated time does not advance while the CPU is busy.
+ */
+static uint32_t timestamp_us(void)
+{
+#ifdef CONFIG_ARCH_POSIX
+    return (uint32_t)native_rtc_gettime_us(RTC_CLOCK_REAL);
+#else
+    return k_cyc_to_us_floor32(k_cycle_get_32());
+#endif
+}
+
+static void tx_data_ready_cb(const struct device *dev, size_t size, void *user_data)
+{
+    /* another message is sent as soon as the first bytes of a report stream were transmitted */
+    if (atomic_cas(&interfering_armed, 1, 0)) {
+        k_work_submit(&interfering_work);
+    }
+
+    k_sem_give(&tx_data_sem);
+}
+
+/* appends CRC (if enabled) and line end to a text mode request */
+static int build_text_request(char *buf, size_t size, const char *req)
+{
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+    return snprintf(buf, size, "%s %08X#\n", req,
+                    crc32_ieee((const uint8_t *)req, strlen(req)));
+#else
+    return snprintf(buf, size, "%s\n", req);
+#endif
+}
+
+static void send_text_request(const char *req)
+{
+    char buf[64];
+    int len = build_text_request(buf, sizeof(buf), req);
+
+    uart_emul_put_rx_data(uart_dev, buf, len);
+}
+
+/*
+ * Append CRC to a binary message (prepended by the channel ID in multi-channel mode) and apply
+ * SLIP-style encoding as in packetizer.c
+ */
+static int build_bin_frame(uint8_t *frame, uint8_t channel, const uint8_t *msg, size_t len)
+{
+    uint8_t buf[64];
+    size_t buf_len = 0;
+    int pos = 0;
+
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+    buf[buf_len++] = channel;
+#endif
+    memcpy(buf + buf_len, msg, len);
+    buf_len += len;
+    sys_put_be32(crc32_ieee(buf, buf_len), &buf[buf_len]);
+    buf_len += 4;
+
+    frame[pos++] = 0x0A;
+    for (int i = 0; i < buf_len; i++) {
+        if (buf[i] == 0x0A || buf[i] == 0x0D || buf[i] == 0xCE) {
+            frame[pos++] = 0xCE;
+            frame[pos++] = buf[i] == 0x0A ? 0xCA : (buf[i] == 0x0D ? 0xCD : 0xCF);
+        }
+        else {
+            frame[pos++] = buf[i];
+        }
+    }
+    frame[pos++] = 0x0A;
+
+    return pos;
+}
+
+static void send_bin_request(uint8_t channel, const uint8_t *req, size_t len)
+{
+    uint8_t frame[2 * 64 + 2];
+    int frame_len = build_bin_frame(frame, channel, req, len);
+
+    uart_emul_put_rx_data(uart_dev, frame, frame_len);
+}
+
+/*
+ * Decode the first binary frame in the buffer and check its CRC.
+ *
+ * @returns Length of the message without channel ID and CRC
+ */
+static int decode_bin_frame(const uint8_t *frame, size_t frame_len, uint8_t *channel, uint8_t *msg,
+                            size_t size)
+{
+    bool escape = false;
+    size_t len = 0;
+
+    zassert_equal(frame[0], 0x0A, "missing frame start");
+
+    for (int i = 1; i < frame_len && frame[i] != 0x0A; i++) {
+        uint8_t c = frame[i];
+        if (escape) {
+            c = c == 0xCA ? 0x0A : (c == 0xCD ? 0x0D : 0xCE);
+            escape = false;
+        }
+        else if (c == 0xCE) {
+            escape = true;
+            continue;
+        }
+        zassert_true(len < size, "frame exceeds buffer");
+        msg[len++] = c;
+    }
+
+    zassert_true(len > 4, "frame without CRC");
+    len -= 4;
+    zassert_equal(sys_get_be32(&msg[len]), crc32_ieee(msg, len), "wrong CRC");
+
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+    *channel = msg[0];
+    memmove(msg, msg + 1, --len);
+#else
+    *channel = THINGSET_SERIAL_CHANNEL_LOCAL;
+#endif
+
+    return len;
+}
+
+/* receive the response to a binary request and compare it with the local ThingSet context */
+static void check_bin_response(const uint8_t *frame, size_t frame_len, const uint8_t *req,
+                               size_t req_len)
+{
+    uint8_t rsp[128];
+    uint8_t rsp_exp[128];
+    uint8_t channel;
+
+    int len = decode_bin_frame(frame, frame_len, &channel, rsp, sizeof(rsp));
+    int len_exp = thingset_process_message(&ts, req, req_len, rsp_exp, sizeof(rsp_exp));
+
+    zassert_equal(channel, THINGSET_SERIAL_CHANNEL_LOCAL, "wrong channel %u", channel);
+    zassert_true(len_exp > 0);
+    zassert_equal(len, len_exp, "wrong response length %d", len);
+    zassert_mem_equal(rsp, rsp_exp, len);
+}
+
+/*
+ * Collect data sent by the device until the given number of line ends (\n, which is also the
+ * SLIP end byte) was received. Data exceeding the buffer is only counted.
+ *
+ * @returns Number of received bytes or -EAGAIN in case of timeout
+ */
+static int receive(uint8_t *buf, size_t size, int num_line_ends, k_timeout_t timeout)
+{
+    k_timepoint_t end = sys_timepoint_calc(timeout);
+    uint8_t chunk[64];
+    size_t total = 0;
+
+    while (num_line_ends > 0) {
+        uint32_t len = uart_emul_get_tx_data(uart_dev, chunk, sizeof(chunk));
+        if (len == 0) {
+            if (k_sem_take(&tx_data_sem, sys_timepoint_timeout(end)) != 0) {
+                return -EAGAIN;
+            }
+            continue;
+        }
+
+        for (int i = 0; i < len; i++) {
+            if (chunk[i] == '\n') {
+                num_line_ends--;
+            }
+        }
+
+        if (total < size) {
+            memcpy(buf + total, chunk, MIN(len, size - total));
+        }
+        total += len;
+    }
+
+    return total;
+}
+
+/* reports are sent in the format of the last request, so switch back to text mode */
+static void restore_text_mode(void)
+{
+    send_text_request("?Test");
+    zassert_true(receive(rsp_buf, sizeof(rsp_buf), 1, TEST_RECEIVE_TIMEOUT) > 0);
+}
+
+/* read a counter of the serial interface via the local ThingSet context */
+static uint32_t get_serial_stat(const char *name)
+{
+    const char req[] = "?_Stats/Serial";
+    char rsp[256];
+    char key[32];
+
+    int len = thingset_process_message(&ts, (const uint8_t *)req, strlen(req), (uint8_t *)rsp,
+                                       sizeof(rsp) - 1);
+    zassert_true(len > 0, "reading _Stats failed");
+    rsp[len] = '\0';
+
+    snprintf(key, sizeof(key), "\"%s\":", name);
+    char *value = strstr(rsp, key);
+    zassert_not_null(value, "%s not found in %s", name, rsp);
+
+    return strtoul(value + strlen(key), NULL, 10);
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+ZTEST(thingset_serial, test_text_request)
+{
+    const char rsp_exp[] = ":85 {\"wFloat\":1234.6,\"wString\":\"Hello World!\"}";
+
+    send_text_request("?Test");
+
+    int len = receive(rsp_buf, sizeof(rsp_buf), 1, TEST_RECEIVE_TIMEOUT);
+    zassert_true(len > 0, "receive timeout");
+    zassert_mem_equal(rsp_buf, rsp_exp, strlen(rsp_exp));
+
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+    zassert_equal(len, strlen(rsp_exp) + 12, "wrong response length %d", len);
+    uint32_t crc_rx = strtoul((char *)rsp_buf + strlen(rsp_exp) + 1, NULL, 16);
+    zassert_equal(crc_rx, crc32_ieee(rsp_buf, strlen(rsp_exp)), "wrong CRC");
+    zassert_mem_equal(rsp_buf + len - 3, "#\r\n", 3);
+#else
+    zassert_equal(len, strlen(rsp_exp) + 2, "wrong response length %d", len);
+#endif
+}
+
+ZTEST(thingset_serial, test_text_request_backspace)
+{
+    const char junk[] = "xxxxxxxxxxxxxxxxxxxxxxxxxx";
+    char req[64];
+    char bs[sizeof(junk) - 1];
+
+    /* characters already added to the RX CRC are deleted again */
+    int len = build_text_request(req, sizeof(req), "?Test/wFloat");
+    memset(bs, '\b', sizeof(bs));
+
+    uart_emul_put_rx_data(uart_dev, req, 6);
+    uart_emul_put_rx_data(uart_dev, junk, strlen(junk));
+    uart_emul_put_rx_data(uart_dev, bs, sizeof(bs));
+    uart_emul_put_rx_data(uart_dev, req + 6, len - 6);
+
+    len = receive(rsp_buf, sizeof(rsp_buf), 1, TEST_RECEIVE_TIMEOUT);
+    zassert_true(len > 0, "receive timeout");
+    zassert_mem_equal(rsp_buf, ":85 1234.6", strlen(":85 1234.6"), "wrong response: %.*s", len,
+                      (char *)rsp_buf);
+}
+
+ZTEST(thingset_serial, test_text_request_utf8)
+{
+    /* lines starting with non-ASCII characters must not be mistaken for binary frames */
+    send_text_request("\xC3\xA4");
+
+    /* the invalid request is answered instead of being dropped due to a bad frame CRC */
+    zassert_true(receive(rsp_buf, sizeof(rsp_buf), 1, TEST_RECEIVE_TIMEOUT) > 0,
+                 "request dropped");
+}
+
+ZTEST(thingset_serial, test_binary_request)
+{
+    /* GET 0x200 */
+    const uint8_t req[] = { 0x01, 0x19, 0x02, 0x00 };
+
+    send_bin_request(THINGSET_SERIAL_CHANNEL_LOCAL, req, sizeof(req));
+
+    /* frame start and end byte */
+    int len = receive(rsp_buf, sizeof(rsp_buf), 2, TEST_RECEIVE_TIMEOUT);
+    zassert_true(len > 0, "receive timeout");
+    zassert_equal(rsp_buf[len - 1], 0x0A);
+    check_bin_response(rsp_buf, len, req, sizeof(req));
+
+    restore_text_mode();
+}
+
+ZTEST(thingset_serial, test_binary_request_escaped)
+{
+    /* GET 0x20A, response also contains bytes to be escaped */
+    const uint8_t req[] = { 0x01, 0x19, 0x02, 0x0A };
+
+    send_bin_request(THINGSET_SERIAL_CHANNEL_LOCAL, req, sizeof(req));
+
+    int len = receive(rsp_buf, sizeof(rsp_buf), 2, TEST_RECEIVE_TIMEOUT);
+    zassert_true(len > 0, "receive timeout");
+    zassert_equal(rsp_buf[len - 1], 0x0A);
+    check_bin_response(rsp_buf, len, req, sizeof(req));
+
+    restore_text_mode();
+}
+
+ZTEST(thingset_serial, test_binary_request_bad_crc)
+{
+    const uint8_t req[] = { 0x01, 0x19, 0x02, 0x01 };
+    uint8_t frame[32];
+
+    /* corrupt the request after the CRC was calculated */
+    int frame_len = build_bin_frame(frame, THINGSET_SERIAL_CHANNEL_LOCAL, req, sizeof(req));
+    uint8_t *cbor_uint16 = memchr(frame, 0x19, frame_len);
+    *cbor_uint16 = 0x1A;
+
+    uint32_t crc_errors_before = get_serial_stat("rCrcErrors");
+
+    uart_emul_put_rx_data(uart_dev, frame, frame_len);
+
+    zassert_equal(receive(rsp_buf, sizeof(rsp_buf), 1, TEST_RECEIVE_TIMEOUT), -EAGAIN,
+                  "response to message with bad CRC");
+    zassert_equal(get_serial_stat("rCrcErrors"), crc_errors_before + 1);
+}
+
+ZTEST(thingset_serial, test_binary_and_text_back_to_back)
+{
+    /* GET 0x201 and GET 0x202 */
+    const uint8_t req1[] = { 0x01, 0x19, 0x02, 0x01 };
+    const uint8_t req2[] = { 0x01, 0x19, 0x02, 0x02 };
+    const char rsp_text_exp[] = ":85 1234.6";
+    uint8_t buf[128];
+    int pos = 0;
+
+    /* the mode is detected for each message */
+    pos += build_bin_frame(buf + pos, THINGSET_SERIAL_CHANNEL_LOCAL, req1, sizeof(req1));
+    pos += build_bin_frame(buf + pos, THINGSET_SERIAL_CHANNEL_LOCAL, req2, sizeof(req2));
+    pos += build_text_request((char *)buf + pos, sizeof(buf) - pos, "?Test/wFloat");
+
+    uart_emul_put_rx_data(uart_dev, buf, pos);
+
+    /* start and end byte of both frames and the text line end */
+    int len = receive(rsp_buf, sizeof(rsp_buf), 5, TEST_RECEIVE_TIMEOUT);
+    zassert_true(len > 0, "receive timeout");
+
+    uint8_t *frame2 = (uint8_t *)memchr(rsp_buf + 1, 0x0A, len - 1) + 1;
+    uint8_t *text = (uint8_t *)memchr(frame2 + 1, 0x0A, len - (frame2 + 1 - rsp_buf)) + 1;
+
+    check_bin_response(rsp_buf, frame2 - rsp_buf, req1, sizeof(req1));
+    check_bin_response(frame2, text - frame2, req2, sizeof(req2));
+    zassert_mem_equal(text, rsp_text_exp, strlen(rsp_text_exp), "wrong response: %.*s",
+                      len - (int)(text - rsp_buf), (char *)text);
+}
+
+#ifdef CONFIG_THINGSET_SERIAL_CHANNELS
+
+static uint8_t gateway_rx_buf[64];
+static size_t gateway_rx_len;
+static K_SEM_DEFINE(gateway_rx_sem, 0, 1);
+
+static void gateway_rx_cb(const uint8_t *buf, size_t len)
+{
+    gateway_rx_len = MIN(len, sizeof(gateway_rx_buf));
+    memcpy(gateway_rx_buf, buf, gateway_rx_len);
+    k_sem_give(&gateway_rx_sem);
+}
+
+ZTEST(thingset_serial, test_channel_gateway_rx)
+{
+    /* request for a remote node and for the local node */
+    const uint8_t req_remote[] = { 0x01, 0x19, 0x02, 0x0A };
+    const uint8_t req_local[] = { 0x01, 0x19, 0x02, 0x01 };
+
+    k_sem_reset(&gateway_rx_sem);
+    thingset_serial_set_rx_callback(gateway_rx_cb);
+
+    send_bin_request(THINGSET_SERIAL_CHANNEL_GATEWAY, req_remote, sizeof(req_remote));
+    send_bin_request(THINGSET_SERIAL_CHANNEL_LOCAL, req_local, sizeof(req_local));
+
+    zassert_ok(k_sem_take(&gateway_rx_sem, TEST_RECEIVE_TIMEOUT), "gateway message not received");
+    zassert_equal(gateway_rx_len, sizeof(req_remote));
+    zassert_mem_equal(gateway_rx_buf, req_remote, sizeof(req_remote));
+
+    /* only the local request is answered */
+    int len = receive(rsp_buf, sizeof(rsp_buf), 2, TEST_RECEIVE_TIMEOUT);
+    thingset_serial_set_rx_callback(NULL);
+    zassert_true(len > 0, "receive timeout");
+    check_bin_response(rsp_buf, len, req_local, sizeof(req_local));
+    zassert_equal(receive(rsp_buf, sizeof(rsp_buf), 1, TEST_RECEIVE_TIMEOUT), -EAGAIN,
+                  "gateway message answered by the local node");
+
+    restore_text_mode();
+}
+
+ZTEST(thingset_serial, test_channel_gateway_tx)
+{
+    /* text mode messages of remote nodes are also framed */
+    const char msg_remote[] = "#Remote/wFloat 1.0";
+    uint8_t msg[64];
+    uint8_t channel;
+
+    zassert_ok(thingset_serial_send_channel(THINGSET_SERIAL_CHANNEL_GATEWAY,
+                                            (const uint8_t *)msg_remote, strlen(msg_remote)));
+
+    int len = receive(rsp_buf, sizeof(rsp_buf), 2, TEST_RECEIVE_TIMEOUT);
+    zassert_true(len > 0, "receive timeout");
+
+    len = decode_bin_frame(rsp_buf, len, &channel, msg, sizeof(msg));
+    zassert_equal(channel, THINGSET_SERIAL_CHANNEL_GATEWAY, "wrong channel %u", channel);
+    zassert_equal(len, strlen(msg_remote));
+    zassert_mem_equal(msg, msg_remote, len);
+}
+
+#endif /* CONFIG_THINGSET_SERIAL_CHANNELS */
+
+ZTEST(thingset_serial, test_pipelined_requests)
+{
+    const char *reqs[] = { "?Test/wFloat", "?Test/wString" };
+    const char *rsps_exp[] = { ":85 1234.6", ":85 \"Hello World!\"" };
+    char buf[64 * CONFIG_THINGSET_SERIAL_RX_BUF_COUNT];
+    int pos = 0;
+
+    /* as many requests as the RX queue can hold, sent without waiting for responses */
+    for (int i = 0; i < CONFIG_THINGSET_SERIAL_RX_BUF_COUNT; i++) {
+        pos += build_text_request(buf + pos, sizeof(buf) - pos, reqs[i % ARRAY_SIZE(reqs)]);
+    }
+
+    uint32_t dropped_before = get_serial_stat("rDroppedRx");
+
+    uart_emul_put_rx_data(uart_dev, buf, pos);
+
+    int len = receive(rsp_buf, sizeof(rsp_buf) - 1, CONFIG_THINGSET_SERIAL_RX_BUF_COUNT,
+                      TEST_RECEIVE_TIMEOUT);
+    zassert_true(len > 0, "not all responses received");
+    zassert_equal(get_serial_stat("rDroppedRx"), dropped_before);
+    rsp_buf[len] = '\0';
+
+    /* responses have to be sent in the same order as the requests */
+    char *line = (char *)rsp_buf;
+    for (int i = 0; i < CONFIG_THINGSET_SERIAL_RX_BUF_COUNT; i++) {
+        const char *rsp_exp = rsps_exp[i % ARRAY_SIZE(rsps_exp)];
+        zassert_mem_equal(line, rsp_exp, strlen(rsp_exp), "wrong response %d: %s", i, line);
+        line = strchr(line, '\n') + 1;
+    }
+}
+
+ZTEST(thingset_serial, test_report_stream)
+{
+    static char rpt_exp[1024];
+    struct thingset_report_handle handle;
+
+    int len_exp = thingset_report_path(&ts, rpt_exp, sizeof(rpt_exp), TS_NAME_SUBSET_LIVE,
+                                       THINGSET_TXT_NAMES_VALUES);
+    zassert_true(len_exp > 3 * CONFIG_THINGSET_SERIAL_REPORT_CHUNK_SIZE, "report too short");
+
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+    int len_line = len_exp + 12;
+#else
+    int len_line = len_exp + 2;
+#endif
+
+    zassert_ok(thingset_sdk_report_handle_init(&handle, TS_NAME_SUBSET_LIVE));
+
+    /* another message is sent while the report is streamed */
+    atomic_set(&interfering_armed, 1);
+
+    zassert_ok(thingset_serial_send_report_stream(&handle));
+
+    int len = receive(rsp_buf, sizeof(rsp_buf), 2, TEST_RECEIVE_TIMEOUT);
+    zassert_true(len > len_line, "receive timeout");
+
+    /* the other message must not be sent in between the chunks */
+    zassert_mem_equal(rsp_buf, rpt_exp, len_exp, "wrong report: %.*s", len, (char *)rsp_buf);
+    zassert_mem_equal(rsp_buf + len_line - 2, "\r\n", 2);
+#ifdef CONFIG_THINGSET_SERIAL_USE_CRC
+    uint32_t crc_rx = strtoul((char *)rsp_buf + len_exp + 1, NULL, 16);
+    zassert_equal(crc_rx, crc32_ieee(rsp_buf, len_exp), "wrong CRC");
+#endif
+    zassert_mem_equal(rsp_buf + len_line, interfering_msg, strlen(interfering_msg),
+                      "wrong message after report: %.*s", len - len_line,
+                      (char *)rsp_buf + len_line);
+}
+
+#ifdef CONFIG_THINGSET_SERIAL_BAUD_NEGOTIATION
+
+ZTEST(thingset_serial, test_baudrate_fallback)
+{
+    struct uart_config cfg;
+    char req[64];
+
+    zassert_ok(uart_config_get(uart_dev, &cfg));
+    uint32_t baudrate = cfg.baudrate;
+
+    snprintf(req, sizeof(req), "!Networking/xSerialBaudrate [%u]", baudrate * 2);
+    send_text_request(req);
+
+    int len = receive(rsp_buf, sizeof(rsp_buf), 1, TEST_RECEIVE_TIMEOUT);
+    zassert_true(len > 0, "receive timeout");
+    zassert_mem_equal(rsp_buf, ":84", 3, "wrong response: %.*s", len, (char *)rsp_buf);
+
+    /* response is sent with the previous baud rate before switching */
+    k_msleep(10);
+    zassert_ok(uart_config_get(uart_dev, &cfg));
+    zassert_equal(cfg.baudrate, baudrate * 2, "baud rate not switched");
+
+    /* no request is sent to confirm the new baud rate */
+    k_msleep(CONFIG_THINGSET_SERIAL_BAUD_TIMEOUT_MS + 10);
+    zassert_ok(uart_config_get(uart_dev, &cfg));
+    zassert_equal(cfg.baudrate, baudrate, "baud rate not restored");
+}
+
+#endif /* CONFIG_THINGSET_SERIAL_BAUD_NEGOTIATION */
+
+ZTEST(thingset_serial, test_benchmark_requests)
+{
+    char req[64];
+    int req_len = build_text_request(req, sizeof(req), "?Test/wFloat");
+    uint32_t dropped_before = get_serial_stat("rDroppedRx");
+    int num_rsp = 0;
+
+    uint32_t t_start = timestamp_us();
+
+    for (int i = 0; i < BENCH_NUM_REQUESTS; i++) {
+        uint32_t t_req = timestamp_us();
+        uart_emul_put_rx_data(uart_dev, req, req_len);
+        if (receive(rsp_buf, sizeof(rsp_buf), 1, TEST_RECEIVE_TIMEOUT) > 0) {
+            latencies_us[num_rsp++] = timestamp_us() - t_req;
+        }
+    }
+
+    uint32_t t_total = MAX(timestamp_us() - t_start, 1);
+
+    zassert_true(num_rsp > 0, "no responses received");
+    qsort(latencies_us, num_rsp, sizeof(latencies_us[0]), compare_u32);
+
+    TC_PRINT("{\"benchmark\":\"serial_requests\",\"rx_mode\":\"%s\",\"crc\":%s,\"requests\":%d,"
+             "\"responses\":%d,\"requests_per_s\":%u,\"p50_us\":%u,\"p99_us\":%u,"
+             "\"dropped\":%u}\n",
+             RX_MODE, IS_ENABLED(CONFIG_THINGSET_SERIAL_USE_CRC) ? "true" : "false",
+             BENCH_NUM_REQUESTS, num_rsp, (uint32_t)((uint64_t)num_rsp * USEC_PER_SEC / t_total),
+             latencies_us[num_rsp / 2], latencies_us[num_rsp * 99 / 100],
+             get_serial_stat("rDroppedRx") - dropped_before);
+}
+
+ZTEST(thingset_serial, test_benchmark_reports)
+{
+    size_t num_bytes = 0;
+    int num_reports = 0;
+    int num_failed = 0;
+
+    uint32_t t_start = timestamp_us();
+
+    for (int i = 0; i < BENCH_NUM_REPORTS; i++) {
+        int err = thingset_serial_send_report("Test");
+        if (err != 0) {
+            num_failed++;
+            continue;
+        }
+
+        int len = receive(rsp_buf, sizeof(rsp_buf), 1, TEST_RECEIVE_TIMEOUT);
+        if (len > 0) {
+            num_bytes += len;
+            num_reports++;
+        }
+    }
+
+    uint32_t t_total = MAX(timestamp_us() - t_start, 1);
+
+    zassert_true(num_reports > 0, "no reports received");
+
+    TC_PRINT("{\"benchmark\":\"serial_reports\",\"rx_mode\":\"%s\",\"crc\":%s,\"reports\":%d,"
+             "\"received\":%d,\"failed\":%d,\"reports_per_s\":%u,\"bytes_per_s\":%u}\n",
+             RX_MODE, IS_ENABLED(CONFIG_THINGSET_SERIAL_USE_CRC) ? "true" : "false",
+             BENCH_NUM_REPORTS, num_reports, num_failed,
+             (uint32_t)((uint64_t)num_reports * USEC_PER_SEC / t_total),
+             (uint32_t)((uint64_t)num_bytes * USEC_PER_SEC / t_total));
+}
+
+static void *thingset_serial_setup(void)
+{
+    uart_emul_callback_tx_data_ready_set(uart_dev, tx_data_ready_cb, NULL);
+
+    return NULL;
+}
+
+static void thingset_serial_before(void *fixture)
+{
+    atomic_set(&interfering_armed, 0);
+    uart_emul_flush_tx_data(uart_dev);
+    k_sem_reset(&tx_data_sem);
+}
+
+ZTEST_SUITE(thingset_serial, NULL, thingset_serial_setup, thingset_serial_before, NULL, NULL);